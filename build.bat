@@ -12,7 +12,7 @@ if "%1"=="debug" (
 REM Create build directory if it doesn't exist
 if not exist "build" mkdir build
 
-g++ -g -std=c++17 %DEBUG_FLAG% main.cpp src/card.cpp src/board.cpp src/game.cpp src/color_manager.cpp src/design_manager.cpp -o build/main.exe -Iinclude -Llib -lSDL3 -lopengl32 -lglu32
+g++ -g -std=c++17 -ffp-contract=off %DEBUG_FLAG% main.cpp src/card.cpp src/board.cpp src/game.cpp src/color_manager.cpp src/design_manager.cpp src/timer_wheel.cpp src/tween_system.cpp src/job_system.cpp src/config_watcher.cpp src/config_parser.cpp src/content_cache.cpp src/save_game.cpp src/autosave.cpp src/profiler.cpp src/journal.cpp src/undo_history.cpp src/input_recording.cpp src/state_hash.cpp src/scenario.cpp src/bot_player.cpp src/alloc_tracker.cpp src/frame_arena.cpp src/pool_allocator.cpp src/stack_impostor.cpp src/camera.cpp src/spatial_grid.cpp -o build/main.exe -Iinclude -Llib -lSDL3 -pthread -lpsapi -lopengl32 -lglu32
 if %errorlevel% equ 0 (
     echo Build successful!
     echo Copying SDL3.dll to build folder...
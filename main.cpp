@@ -1,13 +1,52 @@
 #include "src/game.h"
+#include <cstdlib>
+#include <cstring>
 
 int main(int argc, char* argv[]) {
+    GameOptions options;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pipelined") == 0) {
+            options.pipelined = true;
+        } else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            options.loadPath = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            options.profile = true;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options.recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            options.replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            options.scenarioPath = argv[++i];
+        } else if (strcmp(argv[i], "--cards") == 0 && i + 1 < argc) {
+            options.scenarioCards = (Uint32)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            options.headlessTicks = (Uint32)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--bot") == 0) {
+            options.bot = true;
+        } else if (strcmp(argv[i], "--bot-minutes") == 0 && i + 1 < argc) {
+            options.botMinutes = (Uint32)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--alloc-test") == 0) {
+            options.allocTest = true;
+        } else if (strcmp(argv[i], "--deterministic") == 0) {
+            options.deterministic = true;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--hash-log") == 0 && i + 1 < argc) {
+            options.hashLogPath = argv[++i];
+        } else if (strcmp(argv[i], "--hash-compare") == 0 && i + 1 < argc) {
+            options.hashComparePath = argv[++i];
+        }
+    }
+    
     Game game;
     
-    if (!game.init()) {
+    if (!game.init(options)) {
         return -1;
     }
     
     game.run();
     
-    return 0;
+    return game.getExitCode();
 }
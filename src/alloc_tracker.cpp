@@ -0,0 +1,82 @@
+#include "alloc_tracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    thread_local bool frameThread = false;
+    thread_local Uint64 threadAllocations = 0;
+    thread_local Uint64 threadBytes = 0;
+    std::atomic<Uint64> frameAllocations(0);
+    std::atomic<Uint64> frameBytes(0);
+
+    inline void countAllocation(size_t size) {
+        threadAllocations++;
+        threadBytes += size;
+        if (frameThread) {
+            frameAllocations.fetch_add(1, std::memory_order_relaxed);
+            frameBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+
+    void* allocate(size_t size) {
+        countAllocation(size);
+        void* memory = malloc(size ? size : 1);
+        if (!memory) throw std::bad_alloc();
+        return memory;
+    }
+
+    void* allocateAligned(size_t size, size_t alignment) {
+        countAllocation(size);
+        size = (size + alignment - 1) / alignment * alignment; // aligned_alloc wants a multiple
+#ifdef _WIN32
+        void* memory = _aligned_malloc(size ? size : alignment, alignment);
+#else
+        void* memory = aligned_alloc(alignment, size ? size : alignment);
+#endif
+        if (!memory) throw std::bad_alloc();
+        return memory;
+    }
+
+    void releaseAligned(void* memory) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        free(memory);
+#endif
+    }
+}
+
+void AllocTracker::setFrameThread(bool counted) {
+    frameThread = counted;
+}
+
+AllocTracker::Counts AllocTracker::getThreadCounts() {
+    return {threadAllocations, threadBytes};
+}
+
+AllocTracker::Counts AllocTracker::takeFrameCounts() {
+    return {frameAllocations.exchange(0, std::memory_order_relaxed), frameBytes.exchange(0, std::memory_order_relaxed)};
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAligned(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAligned(size, (size_t)alignment); }
+
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { releaseAligned(memory); }
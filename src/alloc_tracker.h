@@ -0,0 +1,23 @@
+#pragma once
+
+#include <SDL3/SDL_stdinc.h>
+
+// Counts heap allocations made through the global operator new (replaced in
+// alloc_tracker.cpp). Every thread counts toward its own thread-local totals,
+// which ProfileScope uses to attribute allocations to scopes. Threads that do
+// per-frame work (main, simulation and job threads) mark themselves with
+// setFrameThread; their allocations also go to the process-wide frame counters
+// the profiler reads once per frame. Service threads (autosave, journal writer,
+// config watcher) are not counted toward frames.
+namespace AllocTracker {
+    struct Counts {
+        Uint64 allocations;
+        Uint64 bytes;
+    };
+
+    void setFrameThread(bool counted);
+    // Allocations made by the calling thread since it started
+    Counts getThreadCounts();
+    // Allocations made on frame threads since the previous call
+    Counts takeFrameCounts();
+}
@@ -0,0 +1,56 @@
+#include "autosave.h"
+#include <SDL3/SDL_timer.h>
+#include <cstdio>
+
+AutosaveWorker::AutosaveWorker() : busy(false), writtenSequence(0), pending(false), running(false) {}
+
+AutosaveWorker::~AutosaveWorker() {
+    stop();
+}
+
+void AutosaveWorker::start() {
+    if (running) return;
+    running = true;
+    thread = std::thread(&AutosaveWorker::workLoop, this);
+}
+
+void AutosaveWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    condition.notify_all();
+    thread.join();
+}
+
+void AutosaveWorker::submit(const std::string& savePath) {
+    busy.store(true, std::memory_order_release); // Before waking the worker, which clears it when done
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        path = savePath;
+        pending = true;
+    }
+    condition.notify_all();
+}
+
+void AutosaveWorker::workLoop() {
+    while (true) {
+        std::string savePath;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return pending || !running; });
+            if (!pending) return; // Stopping with nothing left to write
+            pending = false;
+            savePath = path;
+        }
+
+        Uint64 startTime = SDL_GetTicksNS();
+        if (writeSaveFile(savePath, buffer)) {
+            printf("[SAVE] Autosaved %zu cards to %s in %.2f ms\n", buffer.cards.size(), savePath.c_str(),
+                   (SDL_GetTicksNS() - startTime) / 1000000.0);
+            writtenSequence.store(buffer.journalSequence, std::memory_order_release);
+        }
+        busy.store(false, std::memory_order_release);
+    }
+}
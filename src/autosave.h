@@ -0,0 +1,43 @@
+#pragma once
+
+#include "save_game.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Writes autosaves on a background thread so the main thread never waits on disk.
+// At a frame boundary Game fills the worker's buffer (a flat copy of the card and
+// stack arrays) and submits it; serialization, fsync and the atomic rename then
+// happen on the worker. While a save is still being written the buffer is not
+// handed out, and Game simply tries again on a later frame.
+class AutosaveWorker {
+private:
+    SaveData buffer;
+    std::string path;
+    std::atomic<bool> busy;    // Buffer belongs to the worker until the write finishes
+    std::atomic<Uint64> writtenSequence;   // journalSequence of the newest autosave on disk
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool pending;
+    bool running;
+
+    void workLoop();
+
+public:
+    AutosaveWorker();
+    ~AutosaveWorker();
+
+    void start();
+    // Finishes a save in progress, then joins the thread
+    void stop();
+
+    // The buffer to capture into, or null while the previous autosave is being written
+    SaveData* acquireBuffer() { return busy.load(std::memory_order_acquire) ? nullptr : &buffer; }
+    // Hands the captured buffer to the worker
+    void submit(const std::string& savePath);
+    Uint64 getWrittenSequence() const { return writtenSequence.load(std::memory_order_acquire); }
+};
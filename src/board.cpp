@@ -1,22 +1,30 @@
 #include "board.h"
 #include "color_manager.h"
+#include "frame_arena.h"
 #include <cmath>
 
 Board::Board() {
     borderWidth = 20.0f;
-    playArea = {borderWidth, borderWidth, 1920 - 2 * borderWidth, 1080 - 2 * borderWidth};
+    setSize(1920, 1080);
 }
 
-void Board::render(SDL_Renderer* renderer, const ColorManager& colorManager) {
+void Board::setSize(float width, float height) {
+    area = {0, 0, width, height};
+    playArea = {borderWidth, borderWidth, width - 2 * borderWidth, height - 2 * borderWidth};
+}
+
+void Board::render(SDL_Renderer* renderer, FrameArena& arena, const ColorManager& colorManager, const Camera& camera) const {
+    float zoom = camera.getZoom();
+    
     // Create outer border with rounded corners using config colors
-    SDL_FRect outerRect = {0, 0, 1920, 1080};
+    SDL_FRect outerRect = camera.worldToScreen(area);
     Color borderLight = colorManager.getBorderLight();
-    renderRoundedRect(renderer, outerRect, 30.0f, borderLight.toSDL(), true);
+    renderRoundedRect(renderer, arena, outerRect, std::round(30.0f * zoom), borderLight.toSDL(), true);
     
     // Create inner play area with tan playmat color
-    SDL_FRect innerRect = playArea;
+    SDL_FRect innerRect = camera.worldToScreen(playArea);
     Color playmatColor = colorManager.getBackgroundColor();
-    renderRoundedRect(renderer, innerRect, 20.0f, playmatColor.toSDL(), true);
+    renderRoundedRect(renderer, arena, innerRect, std::round(20.0f * zoom), playmatColor.toSDL(), true);
 }
 
 bool Board::isWithinPlayArea(Vector2 pos, Vector2 size) const {
@@ -37,7 +45,7 @@ Vector2 Board::constrainToPlayArea(Vector2 pos, Vector2 size) const {
     return constrained;
 }
 
-void Board::renderRoundedRect(SDL_Renderer* renderer, SDL_FRect rect, float radius, SDL_Color color, bool filled) {
+void Board::renderRoundedRect(SDL_Renderer* renderer, FrameArena& arena, SDL_FRect rect, float radius, SDL_Color color, bool filled) {
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
     
     if (filled) {
@@ -49,22 +57,22 @@ void Board::renderRoundedRect(SDL_Renderer* renderer, SDL_FRect rect, float radi
         SDL_FRect leftRect = {rect.x + radius, rect.y, rect.w - 2 * radius, rect.h};
         SDL_RenderFillRect(renderer, &leftRect);
         
-        // Fill rounded corners
-        for (int y = 0; y < (int)radius; y++) {
-            for (int x = 0; x < (int)radius; x++) {
+        // Fill rounded corners: gather the pixels in the frame arena and submit them in one call
+        int steps = (int)radius;
+        SDL_FPoint* points = arena.allocateArray<SDL_FPoint>((size_t)steps * steps * 4);
+        int count = 0;
+        for (int y = 0; y < steps; y++) {
+            for (int x = 0; x < steps; x++) {
                 float dx = radius - x - 0.5f;
                 float dy = radius - y - 0.5f;
                 if (dx * dx + dy * dy <= radius * radius) {
-                    // Top-left corner
-                    SDL_RenderPoint(renderer, rect.x + x, rect.y + y);
-                    // Top-right corner
-                    SDL_RenderPoint(renderer, rect.x + rect.w - 1 - x, rect.y + y);
-                    // Bottom-left corner
-                    SDL_RenderPoint(renderer, rect.x + x, rect.y + rect.h - 1 - y);
-                    // Bottom-right corner
-                    SDL_RenderPoint(renderer, rect.x + rect.w - 1 - x, rect.y + rect.h - 1 - y);
+                    points[count++] = {rect.x + x, rect.y + y};                               // Top-left
+                    points[count++] = {rect.x + rect.w - 1 - x, rect.y + y};                  // Top-right
+                    points[count++] = {rect.x + x, rect.y + rect.h - 1 - y};                  // Bottom-left
+                    points[count++] = {rect.x + rect.w - 1 - x, rect.y + rect.h - 1 - y};     // Bottom-right
                 }
             }
         }
+        SDL_RenderPoints(renderer, points, count);
     }
 }
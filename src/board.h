@@ -1,23 +1,29 @@
 #pragma once
 
 #include "common.h"
+#include "camera.h"
 
-// Forward declaration
+// Forward declarations
 class ColorManager;
+class FrameArena;
 
 class Board {
 private:
+    SDL_FRect area;         // Whole board in world space, border included
     SDL_FRect playArea;
     float borderWidth;
     
 public:
     Board();
     
-    void render(SDL_Renderer* renderer, const ColorManager& colorManager);
+    // Boards start at the world origin; larger boards are explored with the camera
+    void setSize(float width, float height);
+    void render(SDL_Renderer* renderer, FrameArena& arena, const ColorManager& colorManager, const Camera& camera) const;
+    SDL_FRect getArea() const { return area; }
     SDL_FRect getPlayArea() const { return playArea; }
     bool isWithinPlayArea(Vector2 pos, Vector2 size) const;
     Vector2 constrainToPlayArea(Vector2 pos, Vector2 size) const;
     
 private:
-    void renderRoundedRect(SDL_Renderer* renderer, SDL_FRect rect, float radius, SDL_Color color, bool filled);
+    static void renderRoundedRect(SDL_Renderer* renderer, FrameArena& arena, SDL_FRect rect, float radius, SDL_Color color, bool filled);
 };
@@ -0,0 +1,222 @@
+#include "bot_player.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+BotPlayer::BotPlayer() : dragging(false), dragStep(0), dragSteps(0), idleTicks(0), actions(0),
+                         lastFrameTime(0), windowStart(0), startResident(0), totalFrames(0) {
+    settings = {60.0f, 0.2f, 0.3f, 0.05f, 10.0f};
+}
+
+void BotPlayer::start(Uint64 seed, const BotSettings& botSettings) {
+    random.seed(seed);
+    settings = botSettings;
+    dragging = false;
+    idleTicks = 0;
+    actions = 0;
+    lastFrameTime = SDL_GetTicksNS();
+    windowStart = lastFrameTime;
+    frameTimes.clear();
+    startResident = getResidentBytes();
+    totalFrames = 0;
+}
+
+static Vector2 cardCenter(const Card& card) {
+    return Vector2(card.getPosition().x + card.getSize().x * 0.5f, card.getPosition().y + card.getSize().y * 0.5f);
+}
+
+SDL_Event makeMouseEvent(Uint32 type, Vector2 pos) {
+    SDL_Event e;
+    memset(&e, 0, sizeof(e));
+    e.type = type;
+    if (type == SDL_EVENT_MOUSE_MOTION) {
+        e.motion.x = pos.x;
+        e.motion.y = pos.y;
+    } else {
+        e.button.button = SDL_BUTTON_LEFT;
+        e.button.down = (type == SDL_EVENT_MOUSE_BUTTON_DOWN);
+        e.button.x = pos.x;
+        e.button.y = pos.y;
+    }
+    return e;
+}
+
+void BotPlayer::update(const BotView& view, std::vector<SDL_Event>& out) {
+    if (dragging) {
+        // Follow the curve one step per tick, releasing at the end
+        dragStep++;
+        float t = (float)dragStep / dragSteps;
+        float u = 1.0f - t;
+        Vector2 pos(u * u * from.x + 2 * u * t * control.x + t * t * to.x,
+                    u * u * from.y + 2 * u * t * control.y + t * t * to.y);
+        out.push_back(makeMouseEvent(SDL_EVENT_MOUSE_MOTION, pos));
+        if (dragStep >= dragSteps) {
+            out.push_back(makeMouseEvent(SDL_EVENT_MOUSE_BUTTON_UP, pos));
+            dragging = false;
+            scheduleIdle();
+        }
+        return;
+    }
+    if (idleTicks > 0) {
+        idleTicks--;
+        return;
+    }
+    startAction(view, out);
+    actions++;
+}
+
+void BotPlayer::startAction(const BotView& view, std::vector<SDL_Event>& out) {
+    const std::vector<Card>& cards = *view.cards;
+    const std::vector<Card>& hand = *view.handCards;
+    float roll = random.nextFloat();
+
+    if (roll < settings.undoChance) {
+        SDL_Event e;
+        memset(&e, 0, sizeof(e));
+        e.type = SDL_EVENT_KEY_DOWN;
+        e.key.down = true;
+        e.key.mod = SDL_KMOD_LCTRL;
+        e.key.scancode = (random.nextBelow(3) == 0) ? SDL_SCANCODE_Y : SDL_SCANCODE_Z;
+        out.push_back(e);
+        scheduleIdle();
+        return;
+    }
+    roll -= settings.undoChance;
+
+    Vector2 source, target;
+    if (view.handEnabled && roll < settings.craftChance && pickCraft(view, source, target)) {
+        beginDrag(source, target, out);
+        return;
+    }
+    roll -= settings.craftChance;
+
+    bool fromHand = view.handEnabled && !hand.empty() && (cards.empty() || roll < settings.handChance);
+    if (!fromHand && cards.empty()) {
+        scheduleIdle();
+        return;
+    }
+    const Card& picked = fromHand ? hand[random.nextBelow((Uint32)hand.size())] : cards[random.nextBelow((Uint32)cards.size())];
+    source = cardCenter(picked);
+
+    // Half of the drops land on another card, so stacks keep forming
+    if (!cards.empty() && random.nextBelow(2) == 0) {
+        const Card& other = cards[random.nextBelow((Uint32)cards.size())];
+        target = cardCenter(other);
+    } else {
+        target = randomPoint(view.playArea);
+    }
+    beginDrag(source, target, out);
+}
+
+bool BotPlayer::pickCraft(const BotView& view, Vector2& source, Vector2& target) {
+    // Drag one ingredient of a two-card recipe from the hand onto a lone card of the other
+    const std::vector<Recipe>& recipes = *view.recipes;
+    const std::vector<Card>& cards = *view.cards;
+    if (recipes.empty() || cards.empty()) return false;
+    const Recipe& recipe = recipes[random.nextBelow((Uint32)recipes.size())];
+    if (recipe.ingredients.size() != 2) return false;
+
+    // Probe a bounded number of cards for a stack root of the right type, then check it is alone;
+    // at most one full scan per action keeps large boards cheap
+    const Card* partner = nullptr;
+    Uint32 probes = std::min<Uint32>(64, (Uint32)cards.size());
+    Uint32 start = random.nextBelow((Uint32)cards.size());
+    for (Uint32 i = 0; i < probes && !partner; i++) {
+        const Card& card = cards[(start + i) % cards.size()];
+        if (card.getStackId() == card.getId() && card.getType() == recipe.ingredients[1]) partner = &card;
+    }
+    if (!partner) return false;
+    for (const Card& other : cards) {
+        if (other.getStackId() == partner->getId() && &other != partner) return false;
+    }
+
+    for (const Card& handCard : *view.handCards) {
+        if (handCard.getType() == recipe.ingredients[0]) {
+            source = cardCenter(handCard);
+            target = cardCenter(*partner);
+            return true;
+        }
+    }
+    return false;
+}
+
+Vector2 BotPlayer::randomPoint(const SDL_FRect& area) {
+    return Vector2(area.x + random.nextFloat() * area.w, area.y + random.nextFloat() * area.h);
+}
+
+void BotPlayer::beginDrag(Vector2 start, Vector2 end, std::vector<SDL_Event>& out) {
+    from = start;
+    to = end;
+    // Bow the path sideways by up to half its length
+    float bow = random.nextFloat() - 0.5f;
+    control = Vector2((start.x + end.x) * 0.5f + (start.y - end.y) * bow,
+                      (start.y + end.y) * 0.5f + (end.x - start.x) * bow);
+    dragStep = 0;
+    dragSteps = 8 + random.nextBelow(40);
+    dragging = true;
+    out.push_back(makeMouseEvent(SDL_EVENT_MOUSE_MOTION, start));
+    out.push_back(makeMouseEvent(SDL_EVENT_MOUSE_BUTTON_DOWN, start));
+}
+
+void BotPlayer::scheduleIdle() {
+    // Pauses average out to the configured action rate
+    float meanTicks = settings.actionsPerMinute > 0.0f ? 60.0f * SIM_TICK_RATE / settings.actionsPerMinute : 0.0f;
+    idleTicks = meanTicks >= 1.0f ? random.nextBelow((Uint32)(2.0f * meanTicks)) : 0;
+}
+
+bool BotPlayer::endFrame() {
+    Uint64 now = SDL_GetTicksNS();
+    frameTimes.push_back((now - lastFrameTime) / 1000000.0f);
+    lastFrameTime = now;
+    totalFrames++;
+    return now - windowStart >= (Uint64)(settings.reportSeconds * SDL_NS_PER_SECOND);
+}
+
+void BotPlayer::report(size_t cardCount, int boardProblems) {
+    Uint64 now = SDL_GetTicksNS();
+    float average = 0.0f;
+    float worst = 0.0f;
+    for (float ms : frameTimes) {
+        average += ms;
+        worst = std::max(worst, ms);
+    }
+    average = frameTimes.empty() ? 0.0f : average / frameTimes.size();
+    float p99 = 0.0f;
+    if (!frameTimes.empty()) {
+        size_t rank = frameTimes.size() * 99 / 100;
+        std::nth_element(frameTimes.begin(), frameTimes.begin() + rank, frameTimes.end());
+        p99 = frameTimes[rank];
+    }
+    size_t resident = getResidentBytes();
+    printf("[BOT] %.0f s: %llu actions, %zu cards | frame avg %.2f ms, p99 %.2f ms, max %.2f ms | "
+           "resident %.1f MB (%+.1f MB since start) | board problems: %d\n",
+           (now - windowStart) / 1e9, (unsigned long long)actions, cardCount, average, p99, worst,
+           resident / 1048576.0, ((double)resident - (double)startResident) / 1048576.0, boardProblems);
+    frameTimes.clear();
+    windowStart = now;
+}
+
+size_t BotPlayer::getResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    // Second field of /proc/self/statm is the resident page count
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file) return 0;
+    unsigned long pages = 0, resident = 0;
+    int fields = fscanf(file, "%lu %lu", &pages, &resident);
+    fclose(file);
+    return fields == 2 ? (size_t)resident * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#endif
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "card.h"
+#include "sim_random.h"
+#include <vector>
+
+// What the bot may look at when choosing its next action
+struct BotView {
+    const std::vector<Card>* cards;
+    const std::vector<Card>* handCards;
+    const std::vector<Recipe>* recipes;
+    SDL_FRect playArea;        // Where dropped cards may land
+    bool handEnabled;
+};
+
+struct BotSettings {
+    float actionsPerMinute;
+    float craftChance;         // Share of actions that drag a recipe ingredient from the hand onto its partner
+    float handChance;          // Share of actions that play a random hand card
+    float undoChance;          // Share of actions that press Ctrl+Z (or Ctrl+Y)
+    float reportSeconds;       // Wall-clock interval between stats reports
+};
+
+// A left-button mouse event (motion, down or up) at `pos`, as SDL would deliver it
+SDL_Event makeMouseEvent(Uint32 type, Vector2 pos);
+
+// Synthetic player for soak and load tests. Once per simulation tick it emits
+// the SDL events a person would produce: picking up cards, dragging them along
+// curved paths, stacking them, playing from the hand and undoing. Game feeds the
+// events through the same path as real input. It also gathers frame-time and
+// process memory statistics and reports them periodically.
+class BotPlayer {
+private:
+    SimRandom random;
+    BotSettings settings;
+
+    // Current drag: a quadratic Bezier from `from` through `control` to `to`
+    bool dragging;
+    Vector2 from, control, to;
+    Uint32 dragStep;
+    Uint32 dragSteps;
+    Uint32 idleTicks;
+    Uint64 actions;
+
+    // Stats window
+    Uint64 lastFrameTime;
+    Uint64 windowStart;
+    std::vector<float> frameTimes;     // Milliseconds, this window
+    size_t startResident;              // Bytes resident when the bot started
+    Uint64 totalFrames;
+
+    void startAction(const BotView& view, std::vector<SDL_Event>& out);
+    bool pickCraft(const BotView& view, Vector2& source, Vector2& target);
+    Vector2 randomPoint(const SDL_FRect& area);
+    void beginDrag(Vector2 start, Vector2 end, std::vector<SDL_Event>& out);
+    void scheduleIdle();
+
+public:
+    BotPlayer();
+
+    void start(Uint64 seed, const BotSettings& botSettings);
+    void setSettings(const BotSettings& botSettings) { settings = botSettings; }
+    // Appends this tick's input events
+    void update(const BotView& view, std::vector<SDL_Event>& out);
+    // Call once per frame; returns true when a stats report is due
+    bool endFrame();
+    // Prints the stats gathered since the last report and starts a new window
+    void report(size_t cardCount, int boardProblems);
+    Uint64 getActionCount() const { return actions; }
+
+    // Bytes of physical memory the process uses (0 if unknown)
+    static size_t getResidentBytes();
+};
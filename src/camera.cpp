@@ -0,0 +1,46 @@
+#include "camera.h"
+#include <algorithm>
+
+Camera::Camera() : position(0, 0), zoom(1.0f), viewSize(1920, 1080), bounds({0, 0, 1920, 1080}) {}
+
+void Camera::setViewSize(Vector2 size) {
+    viewSize = size;
+    clampToBounds();
+}
+
+void Camera::setBounds(SDL_FRect area) {
+    bounds = area;
+    clampToBounds();
+}
+
+void Camera::pan(Vector2 delta) {
+    position.x -= delta.x / zoom;
+    position.y -= delta.y / zoom;
+    clampToBounds();
+}
+
+void Camera::zoomAt(Vector2 screenPoint, float factor) {
+    Vector2 anchor = screenToWorld(screenPoint);
+    zoom *= factor;
+    clampToBounds();
+    position = Vector2(anchor.x - screenPoint.x / zoom, anchor.y - screenPoint.y / zoom);
+    clampToBounds();
+}
+
+void Camera::reset() {
+    position = Vector2(bounds.x, bounds.y);
+    zoom = 1.0f;
+    clampToBounds();
+}
+
+void Camera::clampToBounds() {
+    // Zooming out past the point where the whole board is on screen only shows empty space
+    float fit = std::min(viewSize.x / bounds.w, viewSize.y / bounds.h);
+    zoom = std::clamp(zoom, std::min(std::max(fit, MIN_ZOOM), 1.0f), MAX_ZOOM);
+
+    // A board narrower than the view stays at the left (top) edge, as it was before there was a camera
+    float viewW = viewSize.x / zoom;
+    float viewH = viewSize.y / zoom;
+    position.x = (bounds.w > viewW) ? std::clamp(position.x, bounds.x, bounds.x + bounds.w - viewW) : bounds.x;
+    position.y = (bounds.h > viewH) ? std::clamp(position.y, bounds.y, bounds.y + bounds.h - viewH) : bounds.y;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "common.h"
+
+// View onto the board: which world point sits at the screen's top-left corner and
+// how many screen pixels one world unit covers. The simulation owns the camera and
+// moves it from input; each snapshot carries a copy for the renderer. The view is
+// kept inside the board, and zooming out stops once the whole board fits.
+class Camera {
+private:
+    Vector2 position;      // World point shown at the screen's top-left corner
+    float zoom;            // Screen pixels per world unit
+    Vector2 viewSize;      // Screen size in pixels
+    SDL_FRect bounds;      // World area the view stays inside (the board)
+
+    void clampToBounds();
+
+public:
+    static constexpr float MIN_ZOOM = 0.25f;
+    static constexpr float MAX_ZOOM = 2.0f;
+
+    Camera();
+
+    void setViewSize(Vector2 size);
+    void setBounds(SDL_FRect area);
+    // Moves the view by a screen-space distance (dragging the board by `delta` pixels)
+    void pan(Vector2 delta);
+    // Scales the zoom by `factor`, keeping the world point under `screenPoint` in place
+    void zoomAt(Vector2 screenPoint, float factor);
+    // Zoom 1 at the board's top-left corner
+    void reset();
+
+    Vector2 screenToWorld(Vector2 point) const {
+        return Vector2(position.x + point.x / zoom, position.y + point.y / zoom);
+    }
+    SDL_FRect worldToScreen(SDL_FRect rect) const {
+        return {(rect.x - position.x) * zoom, (rect.y - position.y) * zoom, rect.w * zoom, rect.h * zoom};
+    }
+    // World area currently on screen
+    SDL_FRect getViewRect() const { return {position.x, position.y, viewSize.x / zoom, viewSize.y / zoom}; }
+    float getZoom() const { return zoom; }
+};
@@ -1,31 +1,61 @@
 #include "card.h"
+#include <algorithm>
 #include <cstdio>
 #include "debug.h"
 #include "color_manager.h"
 
-Card::Card(CardType t, Vector2 pos) : type(t), position(pos), basePosition(pos), size({95, 132}), 
+Card::Card(CardType t, Vector2 pos) : type(t), id(0), stackId(0), count(1), position(pos), basePosition(pos), size({95, 132}), 
                                      state(CardState::IDLE), animationOffset(0.0f) {}
 
 void Card::render(SDL_Renderer* renderer, const ColorManager& colorManager) const {
-    // Get MTG-themed color for this card type
-    Color cardColor = colorManager.getCardColor(type);
-    
     // Apply animation offset to Y position
     Vector2 renderPos = Vector2(position.x, position.y - animationOffset);
+    renderFace(renderer, colorManager, type, {renderPos.x, renderPos.y, size.x, size.y});
+}
+
+void Card::renderFace(SDL_Renderer* renderer, const ColorManager& colorManager, CardType type, SDL_FRect rect) {
+    renderEdge(renderer, colorManager, type, rect, {rect.w, rect.h});
+}
+
+void Card::renderEdge(SDL_Renderer* renderer, const ColorManager& colorManager, CardType type,
+                      SDL_FRect rect, SDL_FPoint exposed) {
+    // Get MTG-themed color for this card type
+    Color cardColor = colorManager.getCardColor(type);
     
     // Render white border (card frame)
-    renderRoundedRect(renderer, 
-                     {renderPos.x, renderPos.y, size.x, size.y}, 
+    renderRoundedRect(renderer,
+                     rect, 
                      8.0f, 
                      {255, 255, 255, 255}, 
-                     true);
+                     true,
+                     exposed);
     
-    // Render card color (inner area)
-    renderRoundedRect(renderer, 
-                     {renderPos.x + 3, renderPos.y + 3, size.x - 6, size.y - 6}, 
+    // Render card color (inner area); the exposed strip ends at the same screen edge
+    renderRoundedRect(renderer,
+                     {rect.x + 3, rect.y + 3, rect.w - 6, rect.h - 6}, 
                      5.0f, 
                      cardColor.toSDL(), 
-                     true);
+                     true,
+                     {exposed.x - 3, exposed.y - 3});
+}
+
+static const char* CARD_TYPE_NAMES[CARD_TYPE_COUNT] = {
+    "villager", "wood", "rock", "berry", "branch", "log", "plank", "stick"
+};
+
+const char* Card::getTypeName(CardType type) {
+    int index = (int)type;
+    return (index >= 0 && index < CARD_TYPE_COUNT) ? CARD_TYPE_NAMES[index] : "unknown";
+}
+
+bool Card::typeFromName(std::string_view name, CardType& type) {
+    for (int i = 0; i < CARD_TYPE_COUNT; i++) {
+        if (name == CARD_TYPE_NAMES[i]) {
+            type = (CardType)i;
+            return true;
+        }
+    }
+    return false;
 }
 
 void Card::update() {
@@ -45,34 +75,60 @@ bool Card::containsPoint(Vector2 point) const {
     return contains;
 }
 
-void Card::renderRoundedRect(SDL_Renderer* renderer, SDL_FRect rect, float radius, SDL_Color color, bool filled) const {
+// Fills the part of r that lies left of `right` or above `bottom`
+static void fillExposedRect(SDL_Renderer* renderer, SDL_FRect r, float right, float bottom) {
+    float leftWidth = std::min(r.w, right - r.x);
+    if (leftWidth > 0 && r.h > 0) {
+        SDL_FRect left = {r.x, r.y, leftWidth, r.h};
+        SDL_RenderFillRect(renderer, &left);
+    }
+    float topX = std::max(r.x, right);
+    float topWidth = r.x + r.w - topX;
+    float topHeight = std::min(r.h, bottom - r.y);
+    if (topWidth > 0 && topHeight > 0) {
+        SDL_FRect top = {topX, r.y, topWidth, topHeight};
+        SDL_RenderFillRect(renderer, &top);
+    }
+}
+
+void Card::renderRoundedRect(SDL_Renderer* renderer, SDL_FRect rect, float radius, SDL_Color color,
+                             bool filled, SDL_FPoint exposed) {
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
     
     if (filled) {
+        // Only the part left of `right` or above `bottom` is drawn; the rest is covered
+        float right = rect.x + exposed.x;
+        float bottom = rect.y + exposed.y;
+        
         // Fill center rectangle
         SDL_FRect centerRect = {rect.x, rect.y + radius, rect.w, rect.h - 2 * radius};
-        SDL_RenderFillRect(renderer, &centerRect);
+        fillExposedRect(renderer, centerRect, right, bottom);
         
         // Fill left and right rectangles
         SDL_FRect leftRect = {rect.x + radius, rect.y, rect.w - 2 * radius, rect.h};
-        SDL_RenderFillRect(renderer, &leftRect);
+        fillExposedRect(renderer, leftRect, right, bottom);
         
-        // Fill rounded corners
-        for (int y = 0; y < (int)radius; y++) {
-            for (int x = 0; x < (int)radius; x++) {
+        // Fill rounded corners: gather the pixels on the stack and submit them in one call. Card corner
+        // radii are small constants, so the buffer is fixed instead of growing with the cards drawn.
+        const int maxRadius = 8;
+        SDL_FPoint points[maxRadius * maxRadius * 4];
+        int steps = std::min((int)radius, maxRadius);
+        int count = 0;
+        auto addPoint = [&](float px, float py) {
+            if (px < right || py < bottom) points[count++] = {px, py};
+        };
+        for (int y = 0; y < steps; y++) {
+            for (int x = 0; x < steps; x++) {
                 float dx = radius - x - 0.5f;
                 float dy = radius - y - 0.5f;
                 if (dx * dx + dy * dy <= radius * radius) {
-                    // Top-left corner
-                    SDL_RenderPoint(renderer, rect.x + x, rect.y + y);
-                    // Top-right corner
-                    SDL_RenderPoint(renderer, rect.x + rect.w - 1 - x, rect.y + y);
-                    // Bottom-left corner
-                    SDL_RenderPoint(renderer, rect.x + x, rect.y + rect.h - 1 - y);
-                    // Bottom-right corner
-                    SDL_RenderPoint(renderer, rect.x + rect.w - 1 - x, rect.y + rect.h - 1 - y);
+                    addPoint(rect.x + x, rect.y + y);                               // Top-left
+                    addPoint(rect.x + rect.w - 1 - x, rect.y + y);                  // Top-right
+                    addPoint(rect.x + x, rect.y + rect.h - 1 - y);                  // Bottom-left
+                    addPoint(rect.x + rect.w - 1 - x, rect.y + rect.h - 1 - y);     // Bottom-right
                 }
             }
         }
+        SDL_RenderPoints(renderer, points, count);
     }
 }
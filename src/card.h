@@ -1,13 +1,17 @@
 #pragma once
 
 #include "common.h"
+#include <string_view>
 
-// Forward declaration
+// Forward declarations
 class ColorManager;
 
 class Card {
 private:
     CardType type;
+    Uint32 id;             // Unique id assigned by Game, hand cards included (lookups, journal, state hash)
+    Uint32 stackId;        // Id of the stack this card belongs to (its own id when alone)
+    Uint32 count;          // Identical cards this entity stands for; above 1 it is a pile
     Vector2 position;
     Vector2 basePosition;  // Original position for animation
     Vector2 size;
@@ -18,6 +22,17 @@ public:
     Card(CardType t, Vector2 pos);
     
     void render(SDL_Renderer* renderer, const ColorManager& colorManager) const;
+    // Draws a card of the given type into rect (used for snapshots, which hold no Card)
+    static void renderFace(SDL_Renderer* renderer, const ColorManager& colorManager, CardType type, SDL_FRect rect);
+    // Draws only the edge of a card whose lower right is covered by the next card in its stack:
+    // a strip exposed.x wide down the left side and exposed.y high along the top
+    static void renderEdge(SDL_Renderer* renderer, const ColorManager& colorManager, CardType type,
+                           SDL_FRect rect, SDL_FPoint exposed);
+    
+    // Card type registry: lowercase names as used in the config files ("villager", "log", ...)
+    static const char* getTypeName(CardType type);
+    static bool typeFromName(std::string_view name, CardType& type);
+    
     void update();
     
     bool containsPoint(Vector2 point) const;
@@ -28,6 +43,13 @@ public:
     void setBasePosition(Vector2 pos) { basePosition = pos; }
     Vector2 getSize() const { return size; }
     CardType getType() const { return type; }
+    Uint32 getId() const { return id; }
+    void setId(Uint32 newId) { id = newId; }
+    Uint32 getStackId() const { return stackId; }
+    void setStackId(Uint32 newStackId) { stackId = newStackId; }
+    Uint32 getCount() const { return count; }
+    void setCount(Uint32 newCount) { count = newCount; }
+    bool isPile() const { return count > 1; }
     CardState getState() const { return state; }
     void setState(CardState s) { state = s; }
     
@@ -36,5 +58,6 @@ public:
     float getAnimationOffset() const { return animationOffset; }
     
 private:
-    void renderRoundedRect(SDL_Renderer* renderer, SDL_FRect rect, float radius, SDL_Color color, bool filled) const;
+    static void renderRoundedRect(SDL_Renderer* renderer, SDL_FRect rect, float radius, SDL_Color color,
+                                  bool filled, SDL_FPoint exposed);
 };
@@ -1,106 +1,61 @@
 #include "color_manager.h"
+#include "config_parser.h"
+#include "card.h"
 #include "debug.h"
-#include <fstream>
-#include <sstream>
-#include <iostream>
 
 ColorManager::ColorManager() {
     loadDefaultColors();
 }
 
 bool ColorManager::loadFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    std::string text;
+    if (!readConfigFile(filename, text)) {
         DEBUG_PRINT("Could not open color config file: %s, using defaults\n", filename.c_str());
         return false;
     }
     
-    std::string line;
-    std::string currentSection;
-    std::vector<std::pair<std::string, std::string>> cardTypeMappings; // Store for later processing
+    std::vector<std::pair<std::string_view, std::string_view>> cardTypeMappings; // Store for later processing
     
-    while (std::getline(file, line)) {
-        // Remove whitespace
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
-        
-        // Skip empty lines and comments
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-        
-        // Check for section headers
-        if (line[0] == '[' && line.back() == ']') {
-            currentSection = line.substr(1, line.length() - 2);
-            continue;
+    parseIni(text, [&](std::string_view section, std::string_view key, std::string_view value) {
+        if (section == "Card_Types") {
+            // Store card type mappings for later processing
+            cardTypeMappings.push_back({key, value});
+            return;
         }
         
-        // Parse key = value pairs
-        size_t equalPos = line.find('=');
-        if (equalPos != std::string::npos) {
-            std::string key = line.substr(0, equalPos);
-            std::string value = line.substr(equalPos + 1);
-            
-            // Remove whitespace around key and value
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            value.erase(0, value.find_first_not_of(" \t"));
-            
-            // Remove inline comments from value
-            size_t commentPos = value.find('#');
-            if (commentPos != std::string::npos) {
-                value = value.substr(0, commentPos);
-            }
-            value.erase(value.find_last_not_of(" \t") + 1);
-            
-            if (currentSection == "Card_Types") {
-                // Store card type mappings for later processing
-                cardTypeMappings.push_back({key, value});
-                DEBUG_PRINT("Card type mapping stored: %s -> %s\n", key.c_str(), value.c_str());
-            } else {
-                // Check if value is a reference to another color
-                if (colors.find(value) != colors.end()) {
-                    colors[key] = colors[value];
-                    DEBUG_PRINT("Color reference: %s = %s\n", key.c_str(), value.c_str());
-                } else {
-                    colors[key] = parseColor(value);
-                    DEBUG_PRINT("Color parsed: %s = %s\n", key.c_str(), value.c_str());
-                }
-            }
+        // Check if value is a reference to another color
+        auto ref = colors.find(value);
+        Color color = (ref != colors.end()) ? ref->second : parseColor(value);
+        auto it = colors.find(key);
+        if (it != colors.end()) {
+            it->second = color;
+        } else {
+            colors.emplace(std::string(key), color);
         }
-    }
+    });
     
     // Now process card type mappings after all colors are loaded
     for (const auto& mapping : cardTypeMappings) {
-        const std::string& key = mapping.first;
-        const std::string& value = mapping.second;
-        
-        if (key == "villager") cardTypeColors[CardType::VILLAGER] = value;
-        else if (key == "wood") cardTypeColors[CardType::WOOD] = value;
-        else if (key == "rock") cardTypeColors[CardType::ROCK] = value;
-        else if (key == "berry") cardTypeColors[CardType::BERRY] = value;
-        else if (key == "branch") cardTypeColors[CardType::BRANCH] = value;
-        else if (key == "log") cardTypeColors[CardType::LOG] = value;
-        else if (key == "plank") cardTypeColors[CardType::PLANK] = value;
-        else if (key == "stick") cardTypeColors[CardType::STICK] = value;
-        
-        DEBUG_PRINT("Card type mapped: %s -> %s\n", key.c_str(), value.c_str());
+        CardType type;
+        if (Card::typeFromName(mapping.first, type)) {
+            cardTypeColors[type] = std::string(mapping.second);
+        }
     }
     
     DEBUG_PRINT("Loaded color configuration from %s\n", filename.c_str());
     return true;
 }
 
-Color ColorManager::parseColor(const std::string& colorString) {
-    std::stringstream ss(colorString);
-    std::string token;
-    Color color;
+Color ColorManager::parseColor(std::string_view colorString) {
     int values[4] = {0, 0, 0, 255}; // Default alpha to 255
     int index = 0;
     
-    while (std::getline(ss, token, ',') && index < 4) {
-        values[index] = std::stoi(token);
-        index++;
+    size_t pos = 0;
+    while (pos <= colorString.size() && index < 4) {
+        size_t comma = colorString.find(',', pos);
+        if (comma == std::string_view::npos) comma = colorString.size();
+        values[index++] = parseIntView(colorString.substr(pos, comma - pos));
+        pos = comma + 1;
     }
     
     return Color(values[0], values[1], values[2], values[3]);
@@ -128,6 +83,8 @@ void ColorManager::loadDefaultColors() {
     colors["click_indicator"] = Color(255, 0, 0, 255);
     colors["animation_border"] = Color(255, 255, 0, 255);
     colors["drag_border"] = Color(0, 100, 255, 255);
+    colors["progress_bar"] = Color(255, 215, 0, 255);
+    colors["progress_background"] = Color(50, 50, 50, 200);
     
     // Default card type mappings
     cardTypeColors[CardType::VILLAGER] = "white";
@@ -140,12 +97,12 @@ void ColorManager::loadDefaultColors() {
     cardTypeColors[CardType::STICK] = "colorless";
 }
 
-Color ColorManager::getColor(const std::string& name) const {
-    auto it = colors.find(name);
+Color ColorManager::getColor(std::string_view name) const {
+    auto it = colors.find(name); // Heterogeneous lookup: literals don't build a std::string
     if (it != colors.end()) {
         return it->second;
     }
-    DEBUG_PRINT("Color not found: %s, using white\n", name.c_str());
+    DEBUG_PRINT("Color not found: %.*s, using white\n", (int)name.size(), name.data());
     return Color(255, 255, 255, 255); // Default to white
 }
 
@@ -3,6 +3,7 @@
 #include "common.h"
 #include <map>
 #include <string>
+#include <string_view>
 
 struct Color {
     Uint8 r, g, b, a;
@@ -17,17 +18,19 @@ struct Color {
 
 class ColorManager {
 private:
-    std::map<std::string, Color> colors;
+    std::map<std::string, Color, std::less<>> colors;
     std::map<CardType, std::string> cardTypeColors;
     
-    Color parseColor(const std::string& colorString);
+    Color parseColor(std::string_view colorString);
     void loadDefaultColors();
     
+    friend class ContentCache;  // Serializes the palette
+    
 public:
     ColorManager();
     bool loadFromFile(const std::string& filename);
     
-    Color getColor(const std::string& name) const;
+    Color getColor(std::string_view name) const;
     Color getCardColor(CardType type) const;
     
     // Quick access to common colors
@@ -38,4 +41,6 @@ public:
     Color getDragBorder() const { return getColor("drag_border"); }
     Color getAnimationBorder() const { return getColor("animation_border"); }
     Color getClickIndicator() const { return getColor("click_indicator"); }
+    Color getProgressBar() const { return getColor("progress_bar"); }
+    Color getProgressBackground() const { return getColor("progress_background"); }
 };
@@ -24,6 +24,8 @@ enum class CardType {
     STICK
 };
 
+const int CARD_TYPE_COUNT = 8;
+
 enum class CardState {
     IDLE,
     ANIMATING,
@@ -39,4 +41,9 @@ struct Vector2 {
 struct Recipe {
     std::vector<CardType> ingredients;
     CardType result;
+    float craftTime;   // Seconds a matching stack must stay intact before the result appears
 };
+
+// Fixed simulation rate; Game::update advances exactly one tick per call
+const int SIM_TICK_RATE = 60;
+const float SIM_TICK_SECONDS = 1.0f / SIM_TICK_RATE;
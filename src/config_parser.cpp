@@ -0,0 +1,260 @@
+#include "config_parser.h"
+#include <cstdio>
+#include <cstdlib>
+
+bool readConfigFile(const std::string& path, std::string& out) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(file);
+        return false;
+    }
+
+    out.resize((size_t)size);
+    size_t read = size > 0 ? fread(&out[0], 1, (size_t)size, file) : 0;
+    fclose(file);
+    out.resize(read);
+    return true;
+}
+
+std::string_view trimView(std::string_view text) {
+    size_t first = 0;
+    while (first < text.size() && (text[first] == ' ' || text[first] == '\t')) first++;
+    size_t last = text.size();
+    while (last > first && (text[last - 1] == ' ' || text[last - 1] == '\t')) last--;
+    return text.substr(first, last - first);
+}
+
+int parseIntView(std::string_view text, int fallback) {
+    text = trimView(text);
+    if (text.empty()) return fallback;
+
+    size_t i = 0;
+    bool negative = false;
+    if (text[0] == '-' || text[0] == '+') {
+        negative = text[0] == '-';
+        i = 1;
+    }
+    if (i == text.size()) return fallback;
+
+    int value = 0;
+    for (; i < text.size(); i++) {
+        if (text[i] < '0' || text[i] > '9') return fallback;
+        value = value * 10 + (text[i] - '0');
+    }
+    return negative ? -value : value;
+}
+
+float parseFloatView(std::string_view text, float fallback) {
+    text = trimView(text);
+    char buffer[64];
+    if (text.empty() || text.size() >= sizeof(buffer)) return fallback;
+
+    // strtof needs a terminated string; numbers are short so copy to the stack
+    text.copy(buffer, text.size());
+    buffer[text.size()] = '\0';
+    char* parsedEnd = nullptr;
+    float value = strtof(buffer, &parsedEnd);
+    return (parsedEnd == buffer + text.size()) ? value : fallback;
+}
+
+bool JsonDocument::parse(std::string_view text) {
+    nodes.clear();
+    nodes.reserve(text.size() / 16 + 1); // Rough guess at one value per 16 bytes
+    error.clear();
+    begin = text.data();
+    cursor = begin;
+    end = begin + text.size();
+
+    if (parseValue(std::string_view(), 0) == JsonNode::NONE) {
+        nodes.clear();
+        return false;
+    }
+    skipWhitespace();
+    if (cursor != end) {
+        fail("unexpected data after the root value");
+        nodes.clear();
+        return false;
+    }
+    return true;
+}
+
+const JsonNode* JsonDocument::find(const JsonNode* object, std::string_view key) const {
+    if (!object || object->type != JsonType::OBJECT) return nullptr;
+    for (const JsonNode* child = firstChild(object); child; child = nextSibling(child)) {
+        if (child->key == key) return child;
+    }
+    return nullptr;
+}
+
+float JsonDocument::asFloat(const JsonNode* node, float fallback) {
+    if (!node || node->type != JsonType::NUMBER) return fallback;
+    return parseFloatView(node->text, fallback);
+}
+
+std::string JsonDocument::asString(const JsonNode* node) {
+    if (!node) return std::string();
+
+    std::string out;
+    out.reserve(node->text.size());
+    for (size_t i = 0; i < node->text.size(); i++) {
+        char c = node->text[i];
+        if (c != '\\' || i + 1 == node->text.size()) {
+            out += c;
+            continue;
+        }
+        char escaped = node->text[++i];
+        switch (escaped) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                // Only ASCII code points are expected in config files
+                int code = (int)strtol(std::string(node->text.substr(i + 1, 4)).c_str(), nullptr, 16);
+                out += (code < 128) ? (char)code : '?';
+                i += 4;
+                break;
+            }
+            default: out += escaped; break;
+        }
+    }
+    return out;
+}
+
+Uint32 JsonDocument::addNode(JsonType type, std::string_view key, std::string_view text) {
+    JsonNode node;
+    node.type = type;
+    node.key = key;
+    node.text = text;
+    node.firstChild = JsonNode::NONE;
+    node.nextSibling = JsonNode::NONE;
+    node.childCount = 0;
+    nodes.push_back(node);
+    return (Uint32)nodes.size() - 1;
+}
+
+bool JsonDocument::fail(const char* message) {
+    int line = 1;
+    for (const char* p = begin; p < cursor && p < end; p++) {
+        if (*p == '\n') line++;
+    }
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "line %d: %s", line, message);
+    error = buffer;
+    return false;
+}
+
+void JsonDocument::skipWhitespace() {
+    while (cursor < end) {
+        char c = *cursor;
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            cursor++;
+        } else if (c == '#' || (c == '/' && cursor + 1 < end && cursor[1] == '/')) {
+            while (cursor < end && *cursor != '\n') cursor++;
+        } else {
+            break;
+        }
+    }
+}
+
+bool JsonDocument::parseString(std::string_view& out) {
+    if (cursor >= end || *cursor != '"') return fail("expected a string");
+    const char* start = ++cursor;
+    while (cursor < end && *cursor != '"') {
+        if (*cursor == '\\') cursor++; // Skip the escaped character
+        cursor++;
+    }
+    if (cursor >= end) return fail("unterminated string");
+    out = std::string_view(start, (size_t)(cursor - start));
+    cursor++;
+    return true;
+}
+
+Uint32 JsonDocument::parseValue(std::string_view key, int depth) {
+    if (depth > 64) {
+        fail("nesting too deep");
+        return JsonNode::NONE;
+    }
+
+    skipWhitespace();
+    if (cursor >= end) {
+        fail("unexpected end of input");
+        return JsonNode::NONE;
+    }
+
+    char c = *cursor;
+    if (c == '{' || c == '[') {
+        bool isObject = (c == '{');
+        char close = isObject ? '}' : ']';
+        Uint32 index = addNode(isObject ? JsonType::OBJECT : JsonType::ARRAY, key, std::string_view());
+        Uint32 lastChild = JsonNode::NONE;
+        cursor++;
+
+        while (true) {
+            skipWhitespace();
+            if (cursor < end && *cursor == close) {
+                cursor++;
+                return index;
+            }
+
+            std::string_view childKey;
+            if (isObject) {
+                if (!parseString(childKey)) return JsonNode::NONE;
+                skipWhitespace();
+                if (cursor >= end || *cursor != ':') {
+                    fail("expected ':' after member name");
+                    return JsonNode::NONE;
+                }
+                cursor++;
+            }
+
+            Uint32 child = parseValue(childKey, depth + 1);
+            if (child == JsonNode::NONE) return JsonNode::NONE;
+            if (lastChild == JsonNode::NONE) {
+                nodes[index].firstChild = child;
+            } else {
+                nodes[lastChild].nextSibling = child;
+            }
+            lastChild = child;
+            nodes[index].childCount++;
+
+            skipWhitespace();
+            if (cursor < end && *cursor == ',') {
+                cursor++; // A trailing comma before the closing bracket is tolerated
+            } else if (cursor >= end || *cursor != close) {
+                fail(isObject ? "expected ',' or '}'" : "expected ',' or ']'");
+                return JsonNode::NONE;
+            }
+        }
+    }
+
+    if (c == '"') {
+        std::string_view text;
+        if (!parseString(text)) return JsonNode::NONE;
+        return addNode(JsonType::STRING, key, text);
+    }
+
+    // Literals and numbers run until the next delimiter
+    const char* start = cursor;
+    while (cursor < end && *cursor != ',' && *cursor != '}' && *cursor != ']' &&
+           *cursor != ' ' && *cursor != '\t' && *cursor != '\n' && *cursor != '\r') {
+        cursor++;
+    }
+    std::string_view token(start, (size_t)(cursor - start));
+
+    if (token == "true" || token == "false") return addNode(JsonType::BOOL, key, token);
+    if (token == "null") return addNode(JsonType::NULL_VALUE, key, token);
+    if (!token.empty() && (token[0] == '-' || (token[0] >= '0' && token[0] <= '9'))) {
+        return addNode(JsonType::NUMBER, key, token);
+    }
+
+    cursor = start;
+    fail("unexpected token");
+    return JsonNode::NONE;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <SDL3/SDL_stdinc.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Shared single-pass parsers for the config and content files.
+// Both work over one read-only buffer and hand out string_views into it,
+// so nothing is copied until a consumer decides to keep a value.
+
+// Reads a whole file into out with a single read. Returns false if it can't be opened.
+bool readConfigFile(const std::string& path, std::string& out);
+
+// Trims spaces and tabs from both ends of a view
+std::string_view trimView(std::string_view text);
+
+// Parses a decimal integer / float from a view; returns fallback if the view isn't a number
+int parseIntView(std::string_view text, int fallback = 0);
+float parseFloatView(std::string_view text, float fallback = 0.0f);
+
+enum class JsonType : Uint8 {
+    NULL_VALUE,
+    BOOL,
+    NUMBER,
+    STRING,
+    OBJECT,
+    ARRAY
+};
+
+// One value in a parsed document. Nodes are stored contiguously in document order;
+// children are linked through indices. `text` is the raw token for scalars
+// (strings without their quotes, escapes left as-is).
+struct JsonNode {
+    static const Uint32 NONE = 0xFFFFFFFFu;
+
+    JsonType type;
+    std::string_view key;   // Member name when the parent is an object
+    std::string_view text;
+    Uint32 firstChild;
+    Uint32 nextSibling;
+    Uint32 childCount;
+};
+
+// JSON reader producing a flat node array in one pass. Accepts // and # line
+// comments and trailing commas, since the config files are hand-edited.
+// The parsed text must outlive the document.
+class JsonDocument {
+private:
+    std::vector<JsonNode> nodes;
+    std::string error;
+
+    const char* cursor;
+    const char* end;
+    const char* begin;
+
+    Uint32 parseValue(std::string_view key, int depth);
+    bool parseString(std::string_view& out);
+    void skipWhitespace();
+    Uint32 addNode(JsonType type, std::string_view key, std::string_view text);
+    bool fail(const char* message);
+
+public:
+    bool parse(std::string_view text);
+
+    const JsonNode* getRoot() const { return nodes.empty() ? nullptr : &nodes[0]; }
+    const JsonNode* getNode(Uint32 index) const { return index == JsonNode::NONE ? nullptr : &nodes[index]; }
+    const JsonNode* firstChild(const JsonNode* node) const { return node ? getNode(node->firstChild) : nullptr; }
+    const JsonNode* nextSibling(const JsonNode* node) const { return node ? getNode(node->nextSibling) : nullptr; }
+    // Member lookup by key (linear in the object's member count)
+    const JsonNode* find(const JsonNode* object, std::string_view key) const;
+
+    static bool asBool(const JsonNode* node) { return node && node->type == JsonType::BOOL && node->text == "true"; }
+    static float asFloat(const JsonNode* node, float fallback = 0.0f);
+    static std::string asString(const JsonNode* node);  // Copies and unescapes
+
+    size_t getNodeCount() const { return nodes.size(); }
+    const std::string& getError() const { return error; }
+};
+
+// Single-pass INI reader: calls onEntry(section, key, value) for each `key = value`
+// line. '#' and ';' start comments (also inline after a value).
+template <typename Callback>
+void parseIni(std::string_view text, Callback&& onEntry) {
+    std::string_view section;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t lineEnd = text.find('\n', pos);
+        if (lineEnd == std::string_view::npos) lineEnd = text.size();
+        std::string_view line = trimView(text.substr(pos, lineEnd - pos));
+        pos = lineEnd + 1;
+
+        if (!line.empty() && line.back() == '\r') line = trimView(line.substr(0, line.size() - 1));
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+        if (line[0] == '[' && line.back() == ']') {
+            section = trimView(line.substr(1, line.size() - 2));
+            continue;
+        }
+
+        size_t equalPos = line.find('=');
+        if (equalPos == std::string_view::npos) continue;
+
+        std::string_view key = trimView(line.substr(0, equalPos));
+        std::string_view value = line.substr(equalPos + 1);
+        size_t commentPos = value.find('#');
+        if (commentPos != std::string_view::npos) value = value.substr(0, commentPos);
+        onEntry(section, key, trimView(value));
+    }
+}
@@ -0,0 +1,103 @@
+#include "config_watcher.h"
+#include <chrono>
+#include <cstdio>
+
+ConfigWatcher::ConfigWatcher() : intervalMs(500), pendingColors(nullptr), pendingDesign(nullptr), running(false) {}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+    delete pendingColors.exchange(nullptr);
+    delete pendingDesign.exchange(nullptr);
+}
+
+void ConfigWatcher::start(const std::string& colorsFile, const std::vector<std::string>& designFiles, int pollIntervalMs) {
+    if (running) return;
+    colorsPath = colorsFile;
+    designPaths = designFiles;
+    designTimes.assign(designPaths.size(), std::filesystem::file_time_type());
+    polledDesignTimes.resize(designPaths.size());
+    intervalMs = pollIntervalMs;
+
+    // Record the current versions so we only react to edits made from now on
+    pollTime(colorsPath, colorsTime, colorsTime);
+    for (size_t i = 0; i < designPaths.size(); i++) {
+        pollTime(designPaths[i], designTimes[i], designTimes[i]);
+    }
+
+    running = true;
+    thread = std::thread(&ConfigWatcher::watchLoop, this);
+}
+
+void ConfigWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        if (!running) return;
+        running = false;
+    }
+    sleepCondition.notify_all();
+    thread.join();
+}
+
+bool ConfigWatcher::pollTime(const std::string& path, const std::filesystem::file_time_type& lastTime,
+                             std::filesystem::file_time_type& time) {
+    std::error_code error;
+    std::filesystem::file_time_type current = std::filesystem::last_write_time(path, error);
+    if (error) return false;
+    time = current;
+    return time != lastTime;
+}
+
+void ConfigWatcher::watchLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return !running; });
+            if (!running) return;
+        }
+
+        // Editors may save while we read. A new time is only recorded once its file parsed, so a
+        // failed parse is retried on the next poll even when the final write kept the same time
+        std::filesystem::file_time_type time;
+        if (pollTime(colorsPath, colorsTime, time)) {
+            ColorManager* colors = new ColorManager();
+            bool loaded = false;
+            try {
+                loaded = colors->loadFromFile(colorsPath);
+            } catch (const std::exception&) {
+                loaded = false;
+            }
+            if (loaded) {
+                delete pendingColors.exchange(colors); // Replaces an unconsumed older version
+                colorsTime = time;
+                printf("[CONFIG] Reloaded %s\n", colorsPath.c_str());
+            } else {
+                delete colors;
+            }
+        }
+
+        // The design files are merged, so any change rebuilds from all of them
+        bool designChanged = false;
+        for (size_t i = 0; i < designPaths.size(); i++) {
+            polledDesignTimes[i] = designTimes[i];
+            if (pollTime(designPaths[i], designTimes[i], polledDesignTimes[i])) designChanged = true;
+        }
+        if (designChanged) {
+            DesignManager* design = new DesignManager();
+            bool loaded = true;
+            try {
+                for (const auto& path : designPaths) {
+                    loaded = design->loadFromFile(path) && loaded;
+                }
+            } catch (const std::exception&) {
+                loaded = false;
+            }
+            if (loaded) {
+                delete pendingDesign.exchange(design);
+                designTimes = polledDesignTimes;
+                printf("[CONFIG] Reloaded design settings\n");
+            } else {
+                delete design;
+            }
+        }
+    }
+}
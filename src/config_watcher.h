@@ -0,0 +1,51 @@
+#pragma once
+
+#include "color_manager.h"
+#include "design_manager.h"
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Background hot-reload of colors.conf and the JSON design files.
+// A watcher thread polls the files' modification times; when one changes it
+// parses a brand new ColorManager/DesignManager off the main thread and
+// publishes it through an atomic pointer. Game takes the new object at a frame
+// boundary, so render and input code never lock or see a half-parsed config.
+class ConfigWatcher {
+private:
+    std::string colorsPath;
+    std::vector<std::string> designPaths;   // Merged in order into one DesignManager
+    std::filesystem::file_time_type colorsTime;
+    std::vector<std::filesystem::file_time_type> designTimes;
+    std::vector<std::filesystem::file_time_type> polledDesignTimes;  // Scratch: this poll's times, kept on a good parse
+    int intervalMs;
+
+    std::atomic<ColorManager*> pendingColors;
+    std::atomic<DesignManager*> pendingDesign;
+
+    std::thread thread;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool running;
+
+    void watchLoop();
+    // Reads the file's modification time into `time`; true if it differs from `lastTime`
+    static bool pollTime(const std::string& path, const std::filesystem::file_time_type& lastTime,
+                         std::filesystem::file_time_type& time);
+
+public:
+    ConfigWatcher();
+    ~ConfigWatcher();
+
+    void start(const std::string& colorsFile, const std::vector<std::string>& designFiles, int pollIntervalMs = 500);
+    void stop();
+
+    // Returns a freshly parsed config if one was published since the last call, else null
+    std::unique_ptr<ColorManager> takeColors() { return std::unique_ptr<ColorManager>(pendingColors.exchange(nullptr)); }
+    std::unique_ptr<DesignManager> takeDesign() { return std::unique_ptr<DesignManager>(pendingDesign.exchange(nullptr)); }
+};
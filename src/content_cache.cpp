@@ -0,0 +1,332 @@
+#include "content_cache.h"
+#include "color_manager.h"
+#include "design_manager.h"
+#include "config_parser.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+
+// Bump whenever a record layout or the section order changes (changed defaults are caught by defaultsHash)
+static const Uint32 CACHE_VERSION = 3;
+static const char CACHE_MAGIC[4] = {'S', 'L', 'C', 'C'};
+
+// Sections follow the header back to back in this order; every record is a multiple of 4 bytes
+enum CacheSection {
+    SECTION_BOOLS,        // SettingRecord
+    SECTION_FLOATS,       // SettingRecord (value holds the float's bits)
+    SECTION_STRINGS,      // StringRecord
+    SECTION_COLORS,       // ColorRecord
+    SECTION_CARD_COLORS,  // CardColorRecord
+    SECTION_RECIPES,      // RecipeRecord
+    SECTION_INGREDIENTS,  // Uint32 card type
+    SECTION_TEXT,         // Bytes referenced by offset/length, padded to 4
+    SECTION_COUNT
+};
+
+struct CacheHeader {
+    char magic[4];
+    Uint32 version;
+    Uint64 sourceHash;
+    Uint64 defaultsHash;            // hashDefaults() of the binary that wrote the cache
+    Uint32 counts[SECTION_COUNT];   // Records per section (bytes for SECTION_TEXT, before padding)
+};
+
+struct SettingRecord {
+    Uint32 key;
+    Uint32 value;
+};
+
+struct StringRecord {
+    Uint32 key;
+    Uint32 offset;
+    Uint32 length;
+};
+
+struct ColorRecord {
+    Uint32 nameOffset;
+    Uint32 nameLength;
+    Uint8 r, g, b, a;
+};
+
+struct CardColorRecord {
+    Uint32 type;
+    Uint32 nameOffset;
+    Uint32 nameLength;
+};
+
+struct RecipeRecord {
+    Uint32 firstIngredient;
+    Uint32 ingredientCount;
+    Uint32 result;
+    float craftTime;
+};
+
+static_assert(sizeof(CacheHeader) == 56, "CacheHeader layout changed; bump CACHE_VERSION");
+static_assert(sizeof(SettingRecord) == 8 && sizeof(StringRecord) == 12 && sizeof(ColorRecord) == 12 &&
+              sizeof(CardColorRecord) == 12 && sizeof(RecipeRecord) == 16, "Cache record layout changed");
+
+static const size_t RECORD_SIZES[SECTION_COUNT] = {
+    sizeof(SettingRecord), sizeof(SettingRecord), sizeof(StringRecord), sizeof(ColorRecord),
+    sizeof(CardColorRecord), sizeof(RecipeRecord), sizeof(Uint32), 1
+};
+
+static size_t paddedSize(size_t bytes) {
+    return (bytes + 3) & ~(size_t)3;
+}
+
+// Records are copied out with memcpy; the buffer gives no alignment guarantee
+template <typename T>
+static T readRecord(const char* section, size_t index) {
+    T record;
+    memcpy(&record, section + index * sizeof(T), sizeof(T));
+    return record;
+}
+
+template <typename T>
+static void appendRecord(std::string& blob, const T& record) {
+    blob.append(reinterpret_cast<const char*>(&record), sizeof(T));
+}
+
+Uint64 ContentCache::hashSources(const std::vector<std::string>& files) {
+    // FNV-1a over each file's length followed by its contents
+    Uint64 hash = 14695981039346656037ull;
+    std::string text;
+    for (const std::string& file : files) {
+        Uint64 length = readConfigFile(file, text) ? (Uint64)text.size() : ~0ull;
+        for (int i = 0; i < 8; i++) {
+            hash = (hash ^ ((length >> (i * 8)) & 0xFF)) * 1099511628211ull;
+        }
+        for (char c : text) {
+            hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+        }
+        text.clear();
+    }
+    return hash;
+}
+
+Uint64 ContentCache::hashDefaults() {
+    // FNV-1a over every compiled-in default in key order; the hash maps iterate in no fixed order
+    DesignManager design;
+    ColorManager colors;
+    Uint64 hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    auto mixText = [&mix](const std::string& text) {
+        Uint64 length = text.size();
+        mix(&length, sizeof(length));
+        mix(text.data(), text.size());
+    };
+
+    for (const auto& setting : std::map<Uint32, bool>(design.boolSettings.begin(), design.boolSettings.end())) {
+        Uint8 value = setting.second ? 1 : 0;
+        mix(&setting.first, sizeof(setting.first));
+        mix(&value, sizeof(value));
+    }
+    for (const auto& setting : std::map<Uint32, float>(design.floatSettings.begin(), design.floatSettings.end())) {
+        mix(&setting.first, sizeof(setting.first));
+        mix(&setting.second, sizeof(setting.second));
+    }
+    for (const auto& setting : std::map<Uint32, std::string>(design.stringSettings.begin(), design.stringSettings.end())) {
+        mix(&setting.first, sizeof(setting.first));
+        mixText(setting.second);
+    }
+    for (const auto& color : colors.colors) {
+        Uint8 rgba[4] = {color.second.r, color.second.g, color.second.b, color.second.a};
+        mixText(color.first);
+        mix(rgba, sizeof(rgba));
+    }
+    for (const auto& mapping : colors.cardTypeColors) {
+        Uint32 type = (Uint32)mapping.first;
+        mix(&type, sizeof(type));
+        mixText(mapping.second);
+    }
+    return hash;
+}
+
+bool ContentCache::load(const std::string& path, Uint64 sourceHash,
+                        ColorManager& colors, DesignManager& design, std::vector<Recipe>& recipes) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    (void)path; (void)sourceHash; (void)colors; (void)design; (void)recipes;
+    return false; // Records are stored little-endian; big-endian hosts always parse the text
+#else
+    std::string blob;
+    if (!readConfigFile(path, blob) || blob.size() < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    memcpy(&header, blob.data(), sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+        header.sourceHash != sourceHash || header.defaultsHash != hashDefaults()) {
+        return false;
+    }
+
+    // Locate every section and make sure the file is exactly as long as the header says
+    const char* sections[SECTION_COUNT];
+    size_t offset = sizeof(CacheHeader);
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        sections[i] = blob.data() + offset;
+        offset += paddedSize((size_t)header.counts[i] * RECORD_SIZES[i]);
+    }
+    if (offset != blob.size()) return false;
+
+    const char* text = sections[SECTION_TEXT];
+    Uint32 textSize = header.counts[SECTION_TEXT];
+    auto textView = [&](Uint32 textOffset, Uint32 length, std::string_view& out) {
+        if (textOffset > textSize || length > textSize - textOffset) return false;
+        out = std::string_view(text + textOffset, length);
+        return true;
+    };
+
+    // Build into fresh containers so a damaged record leaves the caller's state alone
+    std::unordered_map<Uint32, bool> boolSettings;
+    std::unordered_map<Uint32, float> floatSettings;
+    std::unordered_map<Uint32, std::string> stringSettings;
+    boolSettings.reserve(header.counts[SECTION_BOOLS]);
+    floatSettings.reserve(header.counts[SECTION_FLOATS]);
+    stringSettings.reserve(header.counts[SECTION_STRINGS]);
+
+    for (Uint32 i = 0; i < header.counts[SECTION_BOOLS]; i++) {
+        SettingRecord record = readRecord<SettingRecord>(sections[SECTION_BOOLS], i);
+        boolSettings[record.key] = record.value != 0;
+    }
+    for (Uint32 i = 0; i < header.counts[SECTION_FLOATS]; i++) {
+        SettingRecord record = readRecord<SettingRecord>(sections[SECTION_FLOATS], i);
+        float value;
+        memcpy(&value, &record.value, sizeof(value));
+        floatSettings[record.key] = value;
+    }
+    for (Uint32 i = 0; i < header.counts[SECTION_STRINGS]; i++) {
+        StringRecord record = readRecord<StringRecord>(sections[SECTION_STRINGS], i);
+        std::string_view value;
+        if (!textView(record.offset, record.length, value)) return false;
+        stringSettings[record.key] = std::string(value);
+    }
+
+    std::map<std::string, Color, std::less<>> palette;
+    std::map<CardType, std::string> cardTypeColors;
+    for (Uint32 i = 0; i < header.counts[SECTION_COLORS]; i++) {
+        ColorRecord record = readRecord<ColorRecord>(sections[SECTION_COLORS], i);
+        std::string_view name;
+        if (!textView(record.nameOffset, record.nameLength, name)) return false;
+        palette.emplace_hint(palette.end(), std::string(name), Color(record.r, record.g, record.b, record.a));
+    }
+    for (Uint32 i = 0; i < header.counts[SECTION_CARD_COLORS]; i++) {
+        CardColorRecord record = readRecord<CardColorRecord>(sections[SECTION_CARD_COLORS], i);
+        std::string_view name;
+        if (record.type >= (Uint32)CARD_TYPE_COUNT || !textView(record.nameOffset, record.nameLength, name)) return false;
+        cardTypeColors[(CardType)record.type] = std::string(name);
+    }
+
+    std::vector<Recipe> recipeTable(header.counts[SECTION_RECIPES]);
+    Uint32 ingredientTotal = header.counts[SECTION_INGREDIENTS];
+    for (Uint32 i = 0; i < header.counts[SECTION_RECIPES]; i++) {
+        RecipeRecord record = readRecord<RecipeRecord>(sections[SECTION_RECIPES], i);
+        if (record.result >= (Uint32)CARD_TYPE_COUNT || record.firstIngredient > ingredientTotal ||
+            record.ingredientCount > ingredientTotal - record.firstIngredient) {
+            return false;
+        }
+        Recipe& recipe = recipeTable[i];
+        recipe.result = (CardType)record.result;
+        recipe.craftTime = record.craftTime;
+        recipe.ingredients.resize(record.ingredientCount);
+        for (Uint32 j = 0; j < record.ingredientCount; j++) {
+            Uint32 type = readRecord<Uint32>(sections[SECTION_INGREDIENTS], record.firstIngredient + j);
+            if (type >= (Uint32)CARD_TYPE_COUNT) return false;
+            recipe.ingredients[j] = (CardType)type;
+        }
+    }
+
+    design.boolSettings = std::move(boolSettings);
+    design.floatSettings = std::move(floatSettings);
+    design.stringSettings = std::move(stringSettings);
+    design.resolveSettings();
+    colors.colors = std::move(palette);
+    colors.cardTypeColors = std::move(cardTypeColors);
+    recipes = std::move(recipeTable);
+    return true;
+#endif
+}
+
+bool ContentCache::save(const std::string& path, Uint64 sourceHash,
+                        const ColorManager& colors, const DesignManager& design, const std::vector<Recipe>& recipes) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    (void)path; (void)sourceHash; (void)colors; (void)design; (void)recipes;
+    return false;
+#else
+    CacheHeader header = {};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.sourceHash = sourceHash;
+    header.defaultsHash = hashDefaults();
+
+    // Strings go to a shared text section and are referenced by offset/length
+    std::string text;
+    auto addText = [&](const std::string& value) {
+        Uint32 textOffset = (Uint32)text.size();
+        text += value;
+        return textOffset;
+    };
+
+    std::string sections[SECTION_COUNT];
+    for (const auto& setting : design.boolSettings) {
+        appendRecord(sections[SECTION_BOOLS], SettingRecord{setting.first, setting.second ? 1u : 0u});
+    }
+    for (const auto& setting : design.floatSettings) {
+        SettingRecord record = {setting.first, 0};
+        memcpy(&record.value, &setting.second, sizeof(record.value));
+        appendRecord(sections[SECTION_FLOATS], record);
+    }
+    for (const auto& setting : design.stringSettings) {
+        Uint32 textOffset = addText(setting.second);
+        appendRecord(sections[SECTION_STRINGS], StringRecord{setting.first, textOffset, (Uint32)setting.second.size()});
+    }
+    for (const auto& color : colors.colors) {
+        Uint32 textOffset = addText(color.first);
+        appendRecord(sections[SECTION_COLORS], ColorRecord{textOffset, (Uint32)color.first.size(),
+                                                           color.second.r, color.second.g, color.second.b, color.second.a});
+    }
+    for (const auto& mapping : colors.cardTypeColors) {
+        Uint32 textOffset = addText(mapping.second);
+        appendRecord(sections[SECTION_CARD_COLORS], CardColorRecord{(Uint32)mapping.first, textOffset, (Uint32)mapping.second.size()});
+    }
+    Uint32 ingredientCount = 0;
+    for (const Recipe& recipe : recipes) {
+        appendRecord(sections[SECTION_RECIPES], RecipeRecord{ingredientCount, (Uint32)recipe.ingredients.size(),
+                                                             (Uint32)recipe.result, recipe.craftTime});
+        for (CardType type : recipe.ingredients) {
+            appendRecord(sections[SECTION_INGREDIENTS], (Uint32)type);
+        }
+        ingredientCount += (Uint32)recipe.ingredients.size();
+    }
+    sections[SECTION_TEXT] = std::move(text);
+
+    std::string blob(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        size_t size = sections[i].size();
+        header.counts[i] = (Uint32)(size / RECORD_SIZES[i]);
+        blob += sections[i];
+        blob.append(paddedSize(size) - size, '\0');
+    }
+    memcpy(&blob[0], &header, sizeof(header)); // Counts are only known once every section is built
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) return false;
+    bool written = fwrite(blob.data(), 1, blob.size(), file) == blob.size();
+    written = (fclose(file) == 0) && written;
+
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(tempPath, path, error);
+    }
+    if (!written || error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common.h"
+#include <string>
+#include <vector>
+
+class ColorManager;
+class DesignManager;
+
+// Compiled form of the text content: palette, card type colors, design settings
+// and the recipe table. The first launch after a config edit parses the text
+// files as usual and writes the result here as fixed-width little-endian records;
+// later launches read the blob with one read and decode each record straight into
+// the managers' tables and the recipe list, with no text parsing at all. The header
+// carries a hash of the source files' contents and one of the compiled-in defaults
+// the files are merged onto, so the cache is ignored as soon as any file changes or
+// a newer binary adds or changes a default.
+class ContentCache {
+public:
+    // Hashes the contents of the source files, in order (a missing file hashes differently from an empty one)
+    static Uint64 hashSources(const std::vector<std::string>& files);
+    // Hashes the design settings and palette a freshly constructed manager starts from
+    static Uint64 hashDefaults();
+
+    // Replaces the managers' state and the recipe table with the cached content.
+    // Returns false, leaving everything untouched, if the cache is missing, stale or damaged.
+    static bool load(const std::string& path, Uint64 sourceHash,
+                     ColorManager& colors, DesignManager& design, std::vector<Recipe>& recipes);
+    // Writes the cache through a temporary file so a crash never leaves a torn blob behind
+    static bool save(const std::string& path, Uint64 sourceHash,
+                     const ColorManager& colors, const DesignManager& design, const std::vector<Recipe>& recipes);
+};
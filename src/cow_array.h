@@ -0,0 +1,79 @@
+#pragma once
+
+#include "pool_allocator.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+struct CowArrayPool {
+    static constexpr const char* name = "undo chunks";
+};
+
+// Persistent array with structural sharing. Elements live in fixed-size chunks
+// grouped into pages; copying a CowArray copies only the page pointers, and a
+// later set() clones just the page and chunk it writes to if a copy still shares
+// them. Snapshotting is therefore O(size / (CHUNK_SIZE * PAGE_SIZE)) and each
+// write after a snapshot costs at most one chunk copy. Unwritten elements read
+// as the fill value. Chunks and pages come from pools, so the copies made after
+// every snapshot recycle the blocks freed by dropped snapshots. Not thread-safe:
+// copies must stay on one thread.
+template <typename T>
+class CowArray {
+public:
+    static const size_t CHUNK_SIZE = 64;   // Elements per chunk
+    static const size_t PAGE_SIZE = 64;    // Chunks per page
+
+private:
+    struct Chunk {
+        T items[CHUNK_SIZE];
+    };
+    struct Page {
+        std::shared_ptr<Chunk> chunks[PAGE_SIZE];
+    };
+
+    using ChunkAllocator = PoolAllocator<Chunk, CowArrayPool>;
+    using PageAllocator = PoolAllocator<Page, CowArrayPool>;
+
+    std::vector<std::shared_ptr<Page>> pages;
+    size_t count;
+    T fill;
+
+public:
+    explicit CowArray(const T& fillValue = T()) : count(0), fill(fillValue) {}
+
+    size_t size() const { return count; }
+
+    const T& get(size_t index) const {
+        size_t pageIndex = index / (CHUNK_SIZE * PAGE_SIZE);
+        if (pageIndex >= pages.size() || !pages[pageIndex]) return fill;
+        const std::shared_ptr<Chunk>& chunk = pages[pageIndex]->chunks[(index / CHUNK_SIZE) % PAGE_SIZE];
+        return chunk ? chunk->items[index % CHUNK_SIZE] : fill;
+    }
+
+    void set(size_t index, const T& value) {
+        size_t pageIndex = index / (CHUNK_SIZE * PAGE_SIZE);
+        if (pageIndex >= pages.size()) pages.resize(pageIndex + 1);
+        if (index >= count) count = index + 1;
+
+        std::shared_ptr<Page>& page = pages[pageIndex];
+        if (!page) {
+            page = std::allocate_shared<Page>(PageAllocator());
+        } else if (page.use_count() > 1) {
+            page = std::allocate_shared<Page>(PageAllocator(), *page); // Shares every chunk with the old page
+        }
+
+        std::shared_ptr<Chunk>& chunk = page->chunks[(index / CHUNK_SIZE) % PAGE_SIZE];
+        if (!chunk) {
+            chunk = std::allocate_shared<Chunk>(ChunkAllocator());
+            for (size_t i = 0; i < CHUNK_SIZE; i++) chunk->items[i] = fill;
+        } else if (chunk.use_count() > 1) {
+            chunk = std::allocate_shared<Chunk>(ChunkAllocator(), *chunk);
+        }
+        chunk->items[index % CHUNK_SIZE] = value;
+    }
+
+    void clear() {
+        pages.clear();
+        count = 0;
+    }
+};
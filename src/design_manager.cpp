@@ -1,134 +1,163 @@
 #include "design_manager.h"
-#include <fstream>
-#include <sstream>
-#include <algorithm>
+#include "config_parser.h"
 #include <iostream>
 
 DesignManager::DesignManager() {
     loadDefaultSettings();
+    resolveSettings();
 }
 
 void DesignManager::loadDefaultSettings() {
     // Default UI Settings
-    boolSettings["ui.showHand"] = true;
-    boolSettings["ui.showDebugInfo"] = false;
-    boolSettings["ui.showRecipeHints"] = true;
-    stringSettings["ui.handPosition"] = "bottom";
-    stringSettings["ui.handSize"] = "medium";
+    boolSettings[designKey("ui.showHand")] = true;
+    boolSettings[designKey("ui.showDebugInfo")] = false;
+    boolSettings[designKey("ui.showRecipeHints")] = true;
+    stringSettings[designKey("ui.handPosition")] = "bottom";
+    stringSettings[designKey("ui.handSize")] = "medium";
     
     // Default Animation Settings
-    boolSettings["animations.enableCardHover"] = true;
-    boolSettings["animations.enablePickupAnimation"] = true;
-    boolSettings["animations.enableDragAnimation"] = true;
-    floatSettings["animations.animationSpeed"] = 1.0f;
+    boolSettings[designKey("animations.enableCardHover")] = true;
+    boolSettings[designKey("animations.enablePickupAnimation")] = true;
+    boolSettings[designKey("animations.enableDragAnimation")] = true;
+    floatSettings[designKey("animations.animationSpeed")] = 1.0f;
     
     // Default Gameplay Settings
-    boolSettings["gameplay.enableAutoRecipes"] = false;
-    boolSettings["gameplay.enableCardStacking"] = true;
-    boolSettings["gameplay.showCardTypes"] = true;
-    floatSettings["gameplay.maxStackSize"] = 30.0f; // Maximum number of cards allowed in a stack by default
+    boolSettings[designKey("gameplay.enableAutoRecipes")] = false;
+    boolSettings[designKey("gameplay.enableCardStacking")] = true;
+    boolSettings[designKey("gameplay.showCardTypes")] = true;
+    floatSettings[designKey("gameplay.maxStackSize")] = 30.0f; // Maximum number of cards allowed in a stack by default
+    boolSettings[designKey("gameplay.parallelCrafting")] = true; // Evaluate recipes for changed stacks on the job system
+    floatSettings[designKey("gameplay.undoLimit")] = 100.0f;
     
     // Default Visual Settings
-    stringSettings["visual.theme"] = "mtg";
-    boolSettings["visual.cardBorders"] = true;
-    boolSettings["visual.playmatBorders"] = true;
-    boolSettings["visual.shadowEffects"] = true;
+    stringSettings[designKey("visual.theme")] = "mtg";
+    boolSettings[designKey("visual.cardBorders")] = true;
+    boolSettings[designKey("visual.playmatBorders")] = true;
+    boolSettings[designKey("visual.shadowEffects")] = true;
+    boolSettings[designKey("visual.collapsedStacks")] = true;
+    boolSettings[designKey("visual.occlusionCulling")] = true;
+    boolSettings[designKey("visual.stackImpostors")] = true;
+    boolSettings[designKey("visual.viewportCulling")] = true;
+    
+    // Default Window Settings
+    stringSettings[designKey("game.window.title")] = "MTG Card Game";
+    floatSettings[designKey("game.window.width")] = 1920.0f;
+    floatSettings[designKey("game.window.height")] = 1080.0f;
+    
+    // Default Save Settings
+    floatSettings[designKey("save.autosaveSeconds")] = 60.0f;
+    stringSettings[designKey("save.autosavePath")] = "autosave.sav";
+    boolSettings[designKey("save.journal")] = true;
+    stringSettings[designKey("save.journalPath")] = "journal";
+    floatSettings[designKey("save.journalSnapshotSeconds")] = 60.0f;
+    
+    // Default Bot Settings
+    floatSettings[designKey("bot.actionsPerMinute")] = 60.0f;
+    floatSettings[designKey("bot.craftChance")] = 0.2f;
+    floatSettings[designKey("bot.handChance")] = 0.3f;
+    floatSettings[designKey("bot.undoChance")] = 0.05f;
+    floatSettings[designKey("bot.reportSeconds")] = 10.0f;
 }
 
 bool DesignManager::loadFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    std::string text;
+    if (!readConfigFile(filename, text)) {
         std::cerr << "[DESIGN] Could not open design file: " << filename << std::endl;
         return false;
     }
     
-    std::string line;
-    std::string currentSection;
-    
-    while (std::getline(file, line)) {
-        // Remove whitespace
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
-        
-        // Skip empty lines and comments
-        if (line.empty() || line[0] == '#' || (line.length() >= 2 && line.substr(0, 2) == "//")) {
-            continue;
-        }
-        
-        // Parse section headers like "ui": { BEFORE checking for brackets
-        if (line.find(':') != std::string::npos && line.find('{') != std::string::npos) {
-            size_t colonPos = line.find(':');
-            currentSection = line.substr(0, colonPos);
-            // Remove quotes and whitespace
-            currentSection.erase(std::remove(currentSection.begin(), currentSection.end(), '"'), currentSection.end());
-            currentSection.erase(std::remove(currentSection.begin(), currentSection.end(), ' '), currentSection.end());
-            continue;
-        }
-        
-        // Handle other JSON-like structure (standalone brackets)
-        if (line.find('{') != std::string::npos || line.find('}') != std::string::npos) {
-            continue; // Skip brackets
-        }
-        
-        // Parse key-value pairs
-        size_t colonPos = line.find(':');
-        if (colonPos != std::string::npos) {
-            std::string key = line.substr(0, colonPos);
-            std::string value = line.substr(colonPos + 1);
-            
-            // Clean up key and value
-            key.erase(std::remove(key.begin(), key.end(), '"'), key.end());
-            key.erase(std::remove(key.begin(), key.end(), ' '), key.end());
-            
-            value.erase(0, value.find_first_not_of(" \t"));
-            value.erase(value.find_last_not_of(" \t,") + 1);
-            value.erase(std::remove(value.begin(), value.end(), '"'), value.end());
-            
-            // Create full key with section
-            std::string fullKey = currentSection + "." + key;
-            
-            // Determine value type and store
-            if (value == "true" || value == "false") {
-                boolSettings[fullKey] = parseBool(value);
-            } else if (value.find('.') != std::string::npos || 
-                      (value.find_first_not_of("0123456789.-") == std::string::npos && !value.empty())) {
-                floatSettings[fullKey] = parseFloat(value);
-            } else {
-                stringSettings[fullKey] = value;
-            }
-        }
+    JsonDocument document;
+    if (!document.parse(text) || document.getRoot()->type != JsonType::OBJECT) {
+        std::cerr << "[DESIGN] Could not parse " << filename << ": " << document.getError() << std::endl;
+        return false;
     }
     
-    file.close();
+    storeSettings(document, document.getRoot(), designKey(""), true);
+    resolveSettings();
     std::cout << "[DESIGN] Loaded settings from " << filename << std::endl;
     return true;
 }
 
-bool DesignManager::parseBool(const std::string& value) {
-    std::string lowerValue = value;
-    std::transform(lowerValue.begin(), lowerValue.end(), lowerValue.begin(), ::tolower);
-    return lowerValue == "true" || lowerValue == "1" || lowerValue == "yes";
+void DesignManager::storeSettings(const JsonDocument& document, const JsonNode* object, Uint32 prefixHash, bool isRoot) {
+    for (const JsonNode* node = document.firstChild(object); node; node = document.nextSibling(node)) {
+        // Full key is "section.key" (deeper objects keep appending), hashed incrementally
+        Uint32 keyHash = isRoot ? designKey(node->key) : designKey(node->key, designKey(".", prefixHash));
+        
+        switch (node->type) {
+            case JsonType::OBJECT:
+                storeSettings(document, node, keyHash, false);
+                break;
+            case JsonType::BOOL:
+                boolSettings[keyHash] = JsonDocument::asBool(node);
+                break;
+            case JsonType::NUMBER:
+                floatSettings[keyHash] = JsonDocument::asFloat(node);
+                break;
+            case JsonType::STRING:
+                stringSettings[keyHash] = JsonDocument::asString(node);
+                break;
+            default:
+                break; // Arrays and nulls aren't settings
+        }
+    }
 }
 
-float DesignManager::parseFloat(const std::string& value) {
-    try {
-        return std::stof(value);
-    } catch (const std::exception&) {
-        return 0.0f;
-    }
+void DesignManager::resolveSettings() {
+    settings.showHand = getBool(designKey("ui.showHand"));
+    settings.showDebugInfo = getBool(designKey("ui.showDebugInfo"));
+    settings.showRecipeHints = getBool(designKey("ui.showRecipeHints"));
+    settings.handPosition = getString(designKey("ui.handPosition"));
+    settings.handSize = getString(designKey("ui.handSize"));
+    
+    settings.enableCardHover = getBool(designKey("animations.enableCardHover"));
+    settings.enablePickupAnimation = getBool(designKey("animations.enablePickupAnimation"));
+    settings.enableDragAnimation = getBool(designKey("animations.enableDragAnimation"));
+    settings.animationSpeed = getFloat(designKey("animations.animationSpeed"));
+    
+    settings.enableAutoRecipes = getBool(designKey("gameplay.enableAutoRecipes"));
+    settings.enableCardStacking = getBool(designKey("gameplay.enableCardStacking"));
+    settings.showCardTypes = getBool(designKey("gameplay.showCardTypes"));
+    settings.maxStackSize = static_cast<int>(getFloat(designKey("gameplay.maxStackSize")));
+    settings.parallelCrafting = getBool(designKey("gameplay.parallelCrafting"));
+    settings.undoLimit = static_cast<int>(getFloat(designKey("gameplay.undoLimit")));
+    
+    settings.theme = getString(designKey("visual.theme"));
+    settings.cardBorders = getBool(designKey("visual.cardBorders"));
+    settings.playmatBorders = getBool(designKey("visual.playmatBorders"));
+    settings.shadowEffects = getBool(designKey("visual.shadowEffects"));
+    settings.collapsedStacks = getBool(designKey("visual.collapsedStacks"));
+    settings.occlusionCulling = getBool(designKey("visual.occlusionCulling"));
+    settings.stackImpostors = getBool(designKey("visual.stackImpostors"));
+    settings.viewportCulling = getBool(designKey("visual.viewportCulling"));
+    
+    settings.windowTitle = getString(designKey("game.window.title"));
+    settings.windowWidth = static_cast<int>(getFloat(designKey("game.window.width")));
+    settings.windowHeight = static_cast<int>(getFloat(designKey("game.window.height")));
+    
+    settings.autosaveSeconds = getFloat(designKey("save.autosaveSeconds"));
+    settings.autosavePath = getString(designKey("save.autosavePath"));
+    settings.journalEnabled = getBool(designKey("save.journal"));
+    settings.journalPath = getString(designKey("save.journalPath"));
+    settings.journalSnapshotSeconds = getFloat(designKey("save.journalSnapshotSeconds"));
+    
+    settings.botActionsPerMinute = getFloat(designKey("bot.actionsPerMinute"));
+    settings.botCraftChance = getFloat(designKey("bot.craftChance"));
+    settings.botHandChance = getFloat(designKey("bot.handChance"));
+    settings.botUndoChance = getFloat(designKey("bot.undoChance"));
+    settings.botReportSeconds = getFloat(designKey("bot.reportSeconds"));
 }
 
-bool DesignManager::getBool(const std::string& key) const {
+bool DesignManager::getBool(Uint32 key) const {
     auto it = boolSettings.find(key);
     return (it != boolSettings.end()) ? it->second : false;
 }
 
-float DesignManager::getFloat(const std::string& key) const {
+float DesignManager::getFloat(Uint32 key) const {
     auto it = floatSettings.find(key);
     return (it != floatSettings.end()) ? it->second : 0.0f;
 }
 
-std::string DesignManager::getString(const std::string& key) const {
+std::string DesignManager::getString(Uint32 key) const {
     auto it = stringSettings.find(key);
     return (it != stringSettings.end()) ? it->second : "";
 }
@@ -1,49 +1,145 @@
 #pragma once
 
+#include <SDL3/SDL_stdinc.h>
 #include <string>
-#include <map>
+#include <string_view>
+#include <unordered_map>
+
+class JsonDocument;
+struct JsonNode;
+
+// FNV-1a hash of a setting key such as "ui.showHand". constexpr so that keys
+// written as literals are hashed at compile time. Passing a previous hash as
+// the seed continues it, so "ui" + "." + "showHand" hashes like "ui.showHand".
+constexpr Uint32 designKey(std::string_view key, Uint32 hash = 2166136261u) {
+    for (size_t i = 0; i < key.size(); i++) {
+        hash = (hash ^ (Uint32)(unsigned char)key[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Typed view of every known design setting, resolved once after loading.
+// Hot paths read these fields directly instead of doing keyed lookups.
+struct DesignSettings {
+    // UI
+    bool showHand;
+    bool showDebugInfo;
+    bool showRecipeHints;
+    std::string handPosition;
+    std::string handSize;
+
+    // Animations
+    bool enableCardHover;
+    bool enablePickupAnimation;
+    bool enableDragAnimation;
+    float animationSpeed;
+
+    // Gameplay
+    bool enableAutoRecipes;
+    bool enableCardStacking;
+    bool showCardTypes;
+    int maxStackSize;
+    bool parallelCrafting;
+    int undoLimit;             // Most undo steps kept
+
+    // Visual
+    std::string theme;
+    bool cardBorders;
+    bool playmatBorders;
+    bool shadowEffects;
+    bool collapsedStacks;      // Covered stack members draw only their visible edge strip
+    bool occlusionCulling;     // Skip cards hidden behind cards higher in z-order
+    bool stackImpostors;       // Draw settled stacks from cached offscreen textures
+    bool viewportCulling;      // Snapshot only the cards inside the camera's view
+
+    // Window (game.json)
+    std::string windowTitle;
+    int windowWidth;
+    int windowHeight;
+
+    // Saving (game.json)
+    float autosaveSeconds;     // 0 disables autosave
+    std::string autosavePath;
+    bool journalEnabled;       // Write-ahead journal for crash recovery between autosaves
+    std::string journalPath;   // Segment files are <journalPath>.<n>.log
+    float journalSnapshotSeconds;  // How often the journal is folded into a new base snapshot; 0 disables the journal
+
+    // Bot player (game.json, used with --bot)
+    float botActionsPerMinute;
+    float botCraftChance;      // Share of actions that set up a recipe
+    float botHandChance;       // Share of actions that play from the hand
+    float botUndoChance;
+    float botReportSeconds;
+};
 
 class DesignManager {
 private:
-    std::map<std::string, bool> boolSettings;
-    std::map<std::string, float> floatSettings;
-    std::map<std::string, std::string> stringSettings;
+    std::unordered_map<Uint32, bool> boolSettings;
+    std::unordered_map<Uint32, float> floatSettings;
+    std::unordered_map<Uint32, std::string> stringSettings;
+    DesignSettings settings;
     
     void loadDefaultSettings();
-    bool parseBool(const std::string& value);
-    float parseFloat(const std::string& value);
+    void resolveSettings();
+    void storeSettings(const JsonDocument& document, const JsonNode* object, Uint32 prefixHash, bool isRoot);
+    
+    friend class ContentCache;  // Serializes the raw setting maps
     
 public:
     DesignManager();
+    // Merges the settings of a JSON file (nested objects become dotted keys)
     bool loadFromFile(const std::string& filename);
     
+    const DesignSettings& getSettings() const { return settings; }
+    
     // UI Settings
-    bool getShowHand() const { return getBool("ui.showHand"); }
-    bool getShowDebugInfo() const { return getBool("ui.showDebugInfo"); }
-    bool getShowRecipeHints() const { return getBool("ui.showRecipeHints"); }
-    std::string getHandPosition() const { return getString("ui.handPosition"); }
-    std::string getHandSize() const { return getString("ui.handSize"); }
+    bool getShowHand() const { return settings.showHand; }
+    bool getShowDebugInfo() const { return settings.showDebugInfo; }
+    bool getShowRecipeHints() const { return settings.showRecipeHints; }
+    std::string getHandPosition() const { return settings.handPosition; }
+    std::string getHandSize() const { return settings.handSize; }
     
     // Animation Settings
-    bool getEnableCardHover() const { return getBool("animations.enableCardHover"); }
-    bool getEnablePickupAnimation() const { return getBool("animations.enablePickupAnimation"); }
-    bool getEnableDragAnimation() const { return getBool("animations.enableDragAnimation"); }
-    float getAnimationSpeed() const { return getFloat("animations.animationSpeed"); }
+    bool getEnableCardHover() const { return settings.enableCardHover; }
+    bool getEnablePickupAnimation() const { return settings.enablePickupAnimation; }
+    bool getEnableDragAnimation() const { return settings.enableDragAnimation; }
+    float getAnimationSpeed() const { return settings.animationSpeed; }
     
     // Gameplay Settings
-    bool getEnableAutoRecipes() const { return getBool("gameplay.enableAutoRecipes"); }
-    bool getEnableCardStacking() const { return getBool("gameplay.enableCardStacking"); }
-    bool getShowCardTypes() const { return getBool("gameplay.showCardTypes"); }
-    int getMaxStackSize() const { return static_cast<int>(getFloat("gameplay.maxStackSize")); }
+    bool getEnableAutoRecipes() const { return settings.enableAutoRecipes; }
+    bool getEnableCardStacking() const { return settings.enableCardStacking; }
+    bool getShowCardTypes() const { return settings.showCardTypes; }
+    int getMaxStackSize() const { return settings.maxStackSize; }
+    bool getParallelCrafting() const { return settings.parallelCrafting; }
+    int getUndoLimit() const { return settings.undoLimit; }
     
     // Visual Settings
-    std::string getTheme() const { return getString("visual.theme"); }
-    bool getCardBorders() const { return getBool("visual.cardBorders"); }
-    bool getPlaymatBorders() const { return getBool("visual.playmatBorders"); }
-    bool getShadowEffects() const { return getBool("visual.shadowEffects"); }
-    
-    // Generic getters
-    bool getBool(const std::string& key) const;
-    float getFloat(const std::string& key) const;
-    std::string getString(const std::string& key) const;
+    std::string getTheme() const { return settings.theme; }
+    bool getCardBorders() const { return settings.cardBorders; }
+    bool getPlaymatBorders() const { return settings.playmatBorders; }
+    bool getShadowEffects() const { return settings.shadowEffects; }
+    bool getCollapsedStacks() const { return settings.collapsedStacks; }
+    bool getOcclusionCulling() const { return settings.occlusionCulling; }
+    bool getStackImpostors() const { return settings.stackImpostors; }
+    bool getViewportCulling() const { return settings.viewportCulling; }
+    
+    // Window Settings
+    std::string getWindowTitle() const { return settings.windowTitle; }
+    int getWindowWidth() const { return settings.windowWidth; }
+    int getWindowHeight() const { return settings.windowHeight; }
+    
+    // Save Settings
+    float getAutosaveSeconds() const { return settings.autosaveSeconds; }
+    std::string getAutosavePath() const { return settings.autosavePath; }
+    bool getJournalEnabled() const { return settings.journalEnabled; }
+    std::string getJournalPath() const { return settings.journalPath; }
+    float getJournalSnapshotSeconds() const { return settings.journalSnapshotSeconds; }
+    
+    // Generic getters (for tooling); prefer the designKey() overloads with literal keys
+    bool getBool(Uint32 key) const;
+    float getFloat(Uint32 key) const;
+    std::string getString(Uint32 key) const;
+    bool getBool(const std::string& key) const { return getBool(designKey(key)); }
+    float getFloat(const std::string& key) const { return getFloat(designKey(key)); }
+    std::string getString(const std::string& key) const { return getString(designKey(key)); }
 };
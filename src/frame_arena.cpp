@@ -0,0 +1,43 @@
+#include "frame_arena.h"
+#include <cstdint>
+
+FrameArena::FrameArena(size_t initialCapacity)
+    : block(new char[initialCapacity]), capacity(initialCapacity), used(0), overflowBytes(0), highWater(0) {}
+
+FrameArena::~FrameArena() {
+    for (char* extra : overflow) {
+        delete[] extra;
+    }
+    delete[] block;
+}
+
+void FrameArena::reset() {
+    size_t frameBytes = used + overflowBytes;
+    if (frameBytes > highWater) highWater = frameBytes;
+    if (!overflow.empty()) {
+        // The frame didn't fit; grow once so the next one like it does
+        for (char* extra : overflow) {
+            delete[] extra;
+        }
+        overflow.clear();
+        delete[] block;
+        capacity = (frameBytes > capacity * 2) ? frameBytes : capacity * 2;
+        block = new char[capacity];
+    }
+    used = 0;
+    overflowBytes = 0;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    // Blocks come from new[], so offsets aligned relative to the block start are aligned in memory
+    size_t offset = (used + alignment - 1) & ~(alignment - 1);
+    if (offset + bytes <= capacity) {
+        used = offset + bytes;
+        return block + offset;
+    }
+    char* extra = new char[bytes + alignment];
+    overflow.push_back(extra);
+    overflowBytes += bytes + alignment;
+    uintptr_t address = ((uintptr_t)extra + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    return reinterpret_cast<void*>(address);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SDL3/SDL_stdinc.h>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Linear allocator for data that only lives for one frame. allocate() bumps an
+// offset in one contiguous block and reset() rewinds it, so transient arrays
+// cost no malloc/free and sit next to each other in cache. A frame that runs
+// past the block is served from extra heap blocks; reset() then replaces
+// everything with a single block big enough for that frame, so the arena
+// settles at the largest frame seen and stops allocating. Not thread-safe:
+// each thread that needs one owns its own arena.
+class FrameArena {
+private:
+    char* block;
+    size_t capacity;
+    size_t used;
+    std::vector<char*> overflow;   // Heap blocks handed out after the main block ran out
+    size_t overflowBytes;
+    size_t highWater;              // Most bytes any frame needed
+
+public:
+    explicit FrameArena(size_t initialCapacity = 64 * 1024);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Frees everything allocated since the last reset
+    void reset();
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialized storage for `count` objects; only for types that need no destructor
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena memory is never destroyed");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    size_t getUsed() const { return used + overflowBytes; }
+    size_t getCapacity() const { return capacity; }
+    size_t getHighWater() const { return highWater; }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.h"
+#include "board.h"
+
+// Everything the renderer needs for one card, captured at the end of a simulation frame
+struct CardSnapshot {
+    SDL_FRect rect;        // World rect with the lift offset already applied
+    CardType type;
+    CardState state;
+    Uint32 id;
+    Uint32 stackId;
+    Uint32 count;          // Pile size (1 for a single card)
+    bool highlighted;      // Debug: card has a running lift animation
+    bool covered;          // The next card of its stack lies exactly one step on top; only the edge shows
+    Sint32 impostor;       // Index into FrameSnapshot::stacks when drawn as part of a cached stack, else -1
+};
+
+// A settled stack the renderer draws as one cached texture (see StackImpostorCache)
+struct StackSnapshot {
+    Uint32 stackId;
+    Uint32 version;        // Changes whenever the stack's membership or order changes
+    Uint32 bottom, top;    // Snapshot indices of its bottom and top members
+    Uint32 count;          // Members in the snapshot (viewport culling may leave some out)
+    bool chained;          // Every member lies exactly one stack step above the previous one
+    SDL_FRect bounds;      // Union of the member rects
+};
+
+struct CraftBarSnapshot {
+    SDL_FRect rect;
+    float progress;        // 0..1
+};
+
+// Immutable view of one frame. The simulation writes one of two snapshots while
+// the renderer reads the other, so render never touches live game state.
+struct FrameSnapshot {
+    std::vector<CardSnapshot> cards;        // Playmat cards that may be on screen, back to front
+    std::vector<CardSnapshot> handCards;    // Screen space: the hand does not move with the camera
+    std::vector<CraftBarSnapshot> craftBars;
+    std::vector<StackSnapshot> stacks;      // Stacks drawn from impostor textures
+    SDL_FPoint coveredEdge;                 // Visible strip of a covered card (the stack step)
+    Board board;
+    Camera camera;                          // Maps the world rects above to the screen
+
+    bool showHand;
+    bool showStats;         // Draw-count overlay (ui.showDebugInfo)
+    bool clipHand;          // Hand is clipped to its strip unless a hand card is being dragged
+    float handClipTop;
+
+    Vector2 lastClickPos;   // Debug overlay
+    Uint64 tick;            // Simulation tick the snapshot was taken at
+};
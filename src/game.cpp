@@ -1,62 +1,342 @@
 #include "game.h"
+#include "content_cache.h"
+#include "config_parser.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
 #include <cstdio>
+#include <algorithm>
+#include <cmath>
 #include "debug.h"
 
-Game::Game() : window(nullptr), renderer(nullptr), running(false), 
-               animatingCard(nullptr), animationTimer(0.0f), animationDuration(0.3f),
-               lastClickPos(Vector2(0, 0)), lastClickedCard(nullptr),
+static const char* COLORS_CONFIG_PATH = "../config/colors.conf";
+static const char* DESIGN_CONFIG_PATH = "../config/design.json";
+static const char* GAME_CONFIG_PATH = "../config/game.json";
+static const char* RECIPES_CONFIG_PATH = "../config/recipes.json";
+static const char* CONTENT_CACHE_PATH = "content.cache";
+static const char* QUICKSAVE_PATH = "quicksave.sav";
+
+// --alloc-test timeline, in ticks from the start: settle, pick up a card, drag it
+// around a circle twice (the first lap warms up every buffer the drag path
+// touches), drop it, settle again, then sit idle. Only the second lap and the
+// final idle stretch are measured.
+static const Uint64 ALLOC_TEST_GRAB_TICK = 60;
+static const Uint64 ALLOC_TEST_LAP_TICKS = 120;
+static const Uint64 ALLOC_TEST_RELEASE_TICK = ALLOC_TEST_GRAB_TICK + 2 * ALLOC_TEST_LAP_TICKS;
+static const Uint64 ALLOC_TEST_IDLE_TICK = ALLOC_TEST_RELEASE_TICK + 60;
+static const Uint64 ALLOC_TEST_END_TICK = ALLOC_TEST_IDLE_TICK + 120;
+static const float ALLOC_TEST_RADIUS = 120.0f;
+
+Game::Game() : window(nullptr), renderer(nullptr), running(false), nextCardId(1), design(&designManager.getSettings()), lastAutosaveTick(0), lastJournalSnapshotTick(0), journalSnapshotDue(false),
+               contentHash(0), replaying(false), inputStartTick(0), randomSeed(0), stateHash(0), botStartTick(0), peakCardCount(0),
+               allocTestStartTick(0), allocTestGrab(Vector2(0, 0)), allocTestLastTick(0), allocTestFrames(0), allocTestFailures(0), exitCode(0),
+               pickupDuration(0.3f), liftDuration(0.12f), relayoutDuration(0.15f),
+               lastClickPos(Vector2(0, 0)), lastMousePos(Vector2(0, 0)), lastClickedCard(nullptr), isPanning(false), outputResized(false),
                draggingCard(nullptr), dragOffset(Vector2(0, 0)), isDragging(false),
                isOverStackTarget(false), stackTargetIndex(-1), stackOverlapThreshold(0.5f), stackVisualOffsetY(8.0f), stackVisualOffsetX(6.0f),
                draggingHandCard(nullptr), handCardOriginalPos(Vector2(0, 0)), isDraggingFromHand(false),
-               hoveredHandCard(nullptr), handCardScale(1.0f), handArea(Vector2(480, 1014)), 
-               handCardSpacing(120.0f) {}
+               hoveredHandCard(nullptr), handCardScale(1.0f), handHoverLift(66.0f), handArea(Vector2(480, 1014)), 
+               handCardSpacing(120.0f), cardIndexDirty(true), cardGridDirty(true), lastTickTime(0), tickAccumulator(0),
+               frontFrame(0), stackVersionCounter(1), stackVersionBase(1), simRequested(false), simFinished(false), simQuit(false) {}
 
 Game::~Game() {
     cleanup();
 }
 
-bool Game::init() {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+bool Game::init(const GameOptions& gameOptions) {
+    options = gameOptions;
+    
+    if (options.headless && options.replayPath.empty() && options.scenarioPath.empty() && !options.bot && !options.allocTest) {
+        printf("[HEADLESS] --headless needs a recording (--replay <file>), a scenario (--scenario <file>), --bot or --alloc-test\n");
         return false;
     }
-    
-    window = SDL_CreateWindow("MTG Card Game", 1920, 1080, SDL_WINDOW_RESIZABLE);
-    if (!window) {
+    if (options.allocTest && (options.bot || !options.replayPath.empty())) {
+        printf("[ALLOC] --alloc-test drives the input itself; it can't be combined with --bot or --replay\n");
         return false;
     }
-    
-    renderer = SDL_CreateRenderer(window, nullptr);
-    if (!renderer) {
+    AllocTracker::setFrameThread(true);
+    if (!options.hashLogPath.empty() || !options.hashComparePath.empty()) {
+        options.deterministic = true; // Hashes are only comparable if input lands on the same ticks
+    }
+    randomSeed = options.seed != 0 ? options.seed : SDL_GetTicksNS();
+    random.seed(randomSeed);
+    if (SDL_Init(options.headless ? 0 : SDL_INIT_VIDEO) < 0) {
         return false;
     }
     
-    // Load color configuration
-    colorManager.loadFromFile("../config/colors.conf");
+    // Colors, design settings (game.json supplies the window settings) and recipes
+    loadContent();
     
-    // Load design configuration
-    designManager.loadFromFile("../config/design.json");
+    // Pick up edits to any of the files while the game is running
+    configWatcher.start(COLORS_CONFIG_PATH, {DESIGN_CONFIG_PATH, GAME_CONFIG_PATH});
+    
+    if (!options.headless) {
+        window = SDL_CreateWindow(design->windowTitle.c_str(), design->windowWidth, design->windowHeight, SDL_WINDOW_RESIZABLE);
+        if (!window) {
+            return false;
+        }
+        
+        renderer = SDL_CreateRenderer(window, nullptr);
+        if (!renderer) {
+            return false;
+        }
+    }
+    
+    updateViewSize();
     
     // Debug: Show key design settings
-    printf("[DESIGN] Hand enabled: %s\n", designManager.getShowHand() ? "true" : "false");
-    printf("[DESIGN] Hover animation: %s\n", designManager.getEnableCardHover() ? "true" : "false");
+    printf("[DESIGN] Hand enabled: %s\n", design->showHand ? "true" : "false");
+    printf("[DESIGN] Hover animation: %s\n", design->enableCardHover ? "true" : "false");
     
     initializeCards();
     initializeHand();
-    initializeRecipes();
+    if (!options.replayPath.empty()) {
+        // A replay must not touch the player's saves, so it skips loading, recovery and the journal
+        if (!startReplay()) {
+            return false;
+        }
+    } else {
+        if (!options.scenarioPath.empty() && !startScenario()) {
+            return false;
+        }
+        if (!options.loadPath.empty()) {
+            loadGame(options.loadPath);
+        }
+        startJournal();
+        if (!options.recordPath.empty()) {
+            startRecording();
+        }
+    }
+    resetUndoHistory();
+    if (options.deterministic) {
+        if (!hashLog.start(options.hashLogPath, options.hashComparePath)) {
+            return false;
+        }
+        printf("[DETERMINISM] Input applied on tick boundaries; random seed %llu\n", (unsigned long long)randomSeed);
+    }
+    if (options.bot) {
+        bot.start(randomSeed, getBotSettings());
+        botStartTick = craftTimers.getCurrentTick();
+        printf("[BOT] Bot player started (%.0f actions/min)\n", design->botActionsPerMinute);
+    }
+    if (options.allocTest) {
+        if (cards.empty()) {
+            printf("[ALLOC] --alloc-test needs at least one card on the playmat\n");
+            return false;
+        }
+        // Grab the topmost card by its centre
+        const Card& card = cards.back();
+        allocTestGrab = Vector2(card.getPosition().x + card.getSize().x * 0.5f, card.getPosition().y + card.getSize().y * 0.5f);
+        allocTestStartTick = craftTimers.getCurrentTick();
+        printf("[ALLOC] Allocation test started: idle and drag frames must not allocate after warm-up\n");
+    }
+    
+    jobs.start();
+    autosave.start();
+    journalSnapshots.start();
+    Profiler::get().setReporting(options.profile);
+    printf("[JOBS] Simulation running on %d threads\n", jobs.getThreadCount());
+    if (options.pipelined) {
+        printf("[PIPELINE] Simulation and rendering run on separate threads\n");
+    }
     
     running = true;
     return true;
 }
 
 void Game::run() {
+    lastTickTime = SDL_GetTicksNS();
+    tickAccumulator = 0;
+    
+    if (options.headless) {
+        runHeadless();
+        return;
+    }
+    if (options.pipelined) {
+        runPipelined();
+        saveOnExit();
+        return;
+    }
+    
     while (running) {
+        applyConfigReloads();
+        applyResize();
+        updateAutosave();
+        updateJournalSnapshot();
         handleEvents();
-        update();
+        runSimulationTicks();
         render();
+        endFrameStats();
+    }
+    saveOnExit();
+}
+
+void Game::runSimulationTicks() {
+    // Run the simulation at a fixed tick rate so craft timers are frame-rate independent
+    const Uint64 tickNS = SDL_NS_PER_SECOND / SIM_TICK_RATE;
+    Uint64 now = SDL_GetTicksNS();
+    tickAccumulator += now - lastTickTime;
+    lastTickTime = now;
+    if (tickAccumulator > 5 * tickNS) {
+        tickAccumulator = 5 * tickNS; // Don't try to catch up after a long stall
+    }
+    while (tickAccumulator >= tickNS) {
+        runBot();
+        runAllocTest();
+        feedReplay();
+        update();
+        tickAccumulator -= tickNS;
+    }
+}
+
+void Game::runPipelined() {
+    // Frame N is drawn from frames[frontFrame] while the simulation produces frame N+1
+    // in the other snapshot; the two threads only meet at the frame boundary.
+    frontFrame = 0;
+    captureSnapshot(frames[frontFrame]);
+    simThread = std::thread(&Game::simulationLoop, this);
+    kickSimulation();
+    
+    while (running) {
+        // SDL events must be pumped on the main thread; they are applied next frame
+        SDL_Event e;
+        while (SDL_PollEvent(&e)) {
+            handleRenderReset(e);
+            handleResize(e);
+            pendingEvents.push_back(e);
+        }
+        
+        renderSnapshot(frames[frontFrame]);
+        
+        waitForSimulation();
+        applyConfigReloads();
+        applyResize();
+        updateAutosave();
+        updateJournalSnapshot();
+        endFrameStats();
+        frontFrame = 1 - frontFrame;
+        simEvents.swap(pendingEvents);
+        pendingEvents.clear();
+        kickSimulation();
+    }
+    
+    waitForSimulation();
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        simQuit = true;
+    }
+    pipelineCondition.notify_all();
+    simThread.join();
+}
+
+void Game::applyConfigReloads() {
+    // Called at a frame boundary when neither render nor simulation is reading the configs
+    std::unique_ptr<ColorManager> colors = configWatcher.takeColors();
+    if (colors) {
+        colorManager = std::move(*colors);
+        impostors.invalidate();
+    }
+    std::unique_ptr<DesignManager> freshDesign = configWatcher.takeDesign();
+    if (freshDesign) {
+        designManager = std::move(*freshDesign); // `design` keeps pointing at designManager's settings
+        bot.setSettings(getBotSettings());
+        impostors.invalidate(); // visual.collapsedStacks changes how members are drawn
+    }
+}
+
+void Game::updateAutosave() {
+    // Called at a frame boundary, like applyConfigReloads, so the board is consistent
+    if (design->autosaveSeconds <= 0.0f || !options.replayPath.empty()) return;
+    Uint64 now = craftTimers.getCurrentTick();
+    if (now - lastAutosaveTick < (Uint64)(design->autosaveSeconds * SIM_TICK_RATE)) return;
+    
+    SaveData* data = autosave.acquireBuffer();
+    if (!data) return; // The previous autosave is still being written; try again next frame
+    {
+        PROFILE_SCOPE("autosave.capture");
+        captureSave(*data);
+    }
+    autosave.submit(design->autosavePath);
+    lastAutosaveTick = now;
+}
+
+void Game::updateJournalSnapshot() {
+    // A new base snapshot lets the writer drop the segments it covers; called at a frame boundary too
+    if (!journal.isActive()) return;
+    journal.markDurable(journalSnapshots.getWrittenSequence());
+    Uint64 now = craftTimers.getCurrentTick();
+    if (!journalSnapshotDue && now - lastJournalSnapshotTick < (Uint64)(design->journalSnapshotSeconds * SIM_TICK_RATE)) return;
+    
+    SaveData* data = journalSnapshots.acquireBuffer();
+    if (!data) return;
+    {
+        PROFILE_SCOPE("journal.snapshot");
+        captureSave(*data);
+    }
+    journal.rotate(); // Entries from here on are not in this snapshot
+    journalSnapshots.submit(Journal::snapshotPath(design->journalPath));
+    lastJournalSnapshotTick = now;
+    journalSnapshotDue = false;
+}
+
+void Game::saveOnExit() {
+    // A clean exit drops the journal, so the autosave is brought up to date for --load
+    if (design->autosaveSeconds <= 0.0f || !options.replayPath.empty()) return;
+    autosave.stop(); // Finishes a save in progress, which would race this one for the file
+    SaveData data;
+    captureSave(data);
+    if (writeSaveFile(design->autosavePath, data)) {
+        printf("[SAVE] Autosaved %zu cards to %s on exit\n", data.cards.size(), design->autosavePath.c_str());
+    }
+}
+
+void Game::simulationLoop() {
+    AllocTracker::setFrameThread(true);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(pipelineMutex);
+            pipelineCondition.wait(lock, [this] { return simRequested || simQuit; });
+            if (simQuit) return;
+            simRequested = false;
+        }
+        
+        for (const SDL_Event& e : simEvents) {
+            dispatchEvent(e);
+        }
+        simEvents.clear();
+        runSimulationTicks();
+        captureSnapshot(frames[1 - frontFrame]);
+        
+        {
+            std::lock_guard<std::mutex> lock(pipelineMutex);
+            simFinished = true;
+        }
+        pipelineCondition.notify_all();
     }
 }
 
+void Game::kickSimulation() {
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        simFinished = false;
+        simRequested = true;
+    }
+    pipelineCondition.notify_all();
+}
+
+void Game::waitForSimulation() {
+    std::unique_lock<std::mutex> lock(pipelineMutex);
+    pipelineCondition.wait(lock, [this] { return simFinished; });
+}
+
 void Game::cleanup() {
+    recorder.stop(craftTimers.getCurrentTick() - inputStartTick);
+    hashLog.stop();
+    configWatcher.stop();
+    autosave.stop();
+    journalSnapshots.stop();
+    journal.stop();
+    jobs.stop();
+    impostors.clear();
     if (renderer) {
         SDL_DestroyRenderer(renderer);
         renderer = nullptr;
@@ -71,6 +351,64 @@ void Game::cleanup() {
 void Game::handleEvents() {
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
+        handleRenderReset(e);
+        handleResize(e);
+        dispatchEvent(e);
+    }
+}
+
+void Game::handleRenderReset(const SDL_Event& e) {
+    // Render-target contents can be lost at any time; a device reset loses the textures themselves
+    if (e.type == SDL_EVENT_RENDER_TARGETS_RESET) {
+        impostors.invalidate();
+    } else if (e.type == SDL_EVENT_RENDER_DEVICE_RESET) {
+        impostors.clear();
+    }
+}
+
+void Game::handleResize(const SDL_Event& e) {
+    if (e.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) {
+        outputResized = true;
+    }
+}
+
+void Game::applyResize() {
+    // Called at a frame boundary, like applyConfigReloads, since the simulation owns the camera
+    if (!outputResized) return;
+    outputResized = false;
+    updateViewSize();
+    followCamera(); // Clamping may have moved the view under a held card
+}
+
+void Game::updateViewSize() {
+    // The view is what the renderer really draws to, which the player may have resized the window away from
+    int width = design->windowWidth;
+    int height = design->windowHeight;
+    if (renderer) {
+        SDL_GetRenderOutputSize(renderer, &width, &height);
+    }
+    camera.setViewSize(Vector2((float)width, (float)height));
+}
+
+void Game::dispatchEvent(const SDL_Event& e) {
+    if (replaying) {
+        // Live input would desynchronize the replay; only let the player close the game
+        if (e.type == SDL_EVENT_QUIT || (e.type == SDL_EVENT_KEY_DOWN && e.key.scancode == SDL_SCANCODE_ESCAPE)) {
+            running = false;
+        }
+        return;
+    }
+    recorder.record(e, craftTimers.getCurrentTick() - inputStartTick);
+    if (options.deterministic) {
+        tickEvents.push_back(e); // Applied by the next update(), the tick the recorder stamped
+        return;
+    }
+    handleEvent(e);
+}
+
+void Game::handleEvent(const SDL_Event& e) {
+    PROFILE_SCOPE("input.event");
+    {
         if (e.type == SDL_EVENT_QUIT) {
             running = false;
         }
@@ -78,43 +416,71 @@ void Game::handleEvents() {
             // Close the game when Escape is pressed
             if (e.key.scancode == SDL_SCANCODE_ESCAPE) {
                 running = false;
+            } else if (e.key.scancode == SDL_SCANCODE_F5) {
+                saveGame(QUICKSAVE_PATH);
+            } else if (e.key.scancode == SDL_SCANCODE_F9) {
+                loadGame(QUICKSAVE_PATH);
+            } else if (e.key.scancode == SDL_SCANCODE_HOME) {
+                camera.reset();
+                followCamera();
+            } else if ((e.key.mod & SDL_KMOD_CTRL) && !isDragging && !isDraggingFromHand) {
+                // Ctrl+Z undoes; Ctrl+Y or Ctrl+Shift+Z redoes
+                if (e.key.scancode == SDL_SCANCODE_Z) {
+                    stepUndoHistory((e.key.mod & SDL_KMOD_SHIFT) != 0);
+                } else if (e.key.scancode == SDL_SCANCODE_Y) {
+                    stepUndoHistory(true);
+                }
             }
         }
         else if (e.type == SDL_EVENT_MOUSE_BUTTON_DOWN) {
             if (e.button.button == SDL_BUTTON_LEFT) {
                 Vector2 mousePos = Vector2((float)e.button.x, (float)e.button.y);
                 lastClickPos = mousePos;
+                lastMousePos = mousePos;
                 
                 DEBUG_CLICK("Mouse down at: (%.1f, %.1f)\n", mousePos.x, mousePos.y);
                 
                 // Check if we clicked a hand card first (only if hand is enabled)
                 Card* clickedHandCard = nullptr;
-                if (designManager.getShowHand()) {
+                if (design->showHand) {
                     clickedHandCard = getHandCardAt(mousePos);
                 }
                 
                 if (clickedHandCard) {
                     DEBUG_CLICK("Starting drag from hand card type: %d\n", (int)clickedHandCard->getType());
                     // Start dragging the hand card instead of immediately playing it
+                    undoHistory.beginAction();
                     startHandCardDrag(clickedHandCard, mousePos);
                 } else {
-                    // Check for playmat cards
-                    Card* clickedCard = getCardAt(mousePos);
+                    // Check for playmat cards; the playmat lives in world space
+                    Vector2 worldPos = camera.screenToWorld(mousePos);
+                    Card* clickedCard = getCardAt(worldPos);
                     if (clickedCard) {
-                        lastClickedCard = clickedCard;
-                        
                         DEBUG_CLICK("Starting drag on playmat card type: %d\n", (int)clickedCard->getType());
-                        
-                        bringCardToFront(clickedCard);
-                        startDrag(clickedCard, mousePos);
+                        pickUpCard(clickedCard, worldPos, false);
                     } else {
                         DEBUG_CLICK("No card found at click position\n");
                     }
                 }
+            } else if (e.button.button == SDL_BUTTON_RIGHT && !isDragging && !isDraggingFromHand) {
+                // Right-drag moves a whole pile instead of taking one card off it
+                Vector2 mousePos = Vector2((float)e.button.x, (float)e.button.y);
+                lastClickPos = mousePos;
+                lastMousePos = mousePos;
+                Vector2 worldPos = camera.screenToWorld(mousePos);
+                Card* clickedCard = getCardAt(worldPos);
+                if (clickedCard) {
+                    pickUpCard(clickedCard, worldPos, true);
+                }
+            } else if (e.button.button == SDL_BUTTON_MIDDLE) {
+                // Middle-drag pans the board
+                isPanning = true;
+                lastMousePos = Vector2((float)e.button.x, (float)e.button.y);
             }
         }
         else if (e.type == SDL_EVENT_MOUSE_BUTTON_UP) {
-            if (e.button.button == SDL_BUTTON_LEFT) {
+            if (e.button.button == SDL_BUTTON_LEFT || e.button.button == SDL_BUTTON_RIGHT) {
+                lastMousePos = Vector2((float)e.button.x, (float)e.button.y);
                 if (isDraggingFromHand) {
                     DEBUG_DRAG("Mouse up - stopping hand card drag\n");
                     stopHandCardDrag();
@@ -122,15 +488,27 @@ void Game::handleEvents() {
                     DEBUG_DRAG("Mouse up - stopping playmat drag\n");
                     stopDrag();
                 }
+            } else if (e.button.button == SDL_BUTTON_MIDDLE) {
+                isPanning = false;
             }
         }
+        else if (e.type == SDL_EVENT_MOUSE_WHEEL) {
+            // Zoom around the cursor, one 10% step per wheel notch
+            lastMousePos = Vector2(e.wheel.mouse_x, e.wheel.mouse_y);
+            camera.zoomAt(lastMousePos, std::pow(1.1f, e.wheel.y));
+            followCamera();
+        }
         else if (e.type == SDL_EVENT_MOUSE_MOTION) {
             Vector2 mousePos = Vector2((float)e.motion.x, (float)e.motion.y);
+            if (isPanning) {
+                camera.pan(Vector2(mousePos.x - lastMousePos.x, mousePos.y - lastMousePos.y));
+            }
+            lastMousePos = mousePos;
             if (isDraggingFromHand) {
                 updateHandCardDrag(mousePos);
             } else if (isDragging) {
-                updateDrag(mousePos);
-            } else if (designManager.getShowHand()) {
+                updateDrag(camera.screenToWorld(mousePos));
+            } else if (design->showHand) {
                 // Update hand hover when not dragging and hand is enabled
                 updateHandHover(mousePos);
             }
@@ -139,65 +517,365 @@ void Game::handleEvents() {
 }
 
 void Game::update() {
-    // Update animation
-    if (animatingCard) {
-        animationTimer += 0.016f; // Assuming ~60 FPS
-        
-        if (animationTimer >= animationDuration) {
-            // Animation finished
-            animatingCard->setAnimationOffset(0.0f);
-            animatingCard->setState(CardState::IDLE);
-            animatingCard = nullptr;
-            animationTimer = 0.0f;
-        } else {
-            // Calculate animation progress (0 to 1)
-            float progress = animationTimer / animationDuration;
-            
-            // Use sine wave for smooth bounce effect
-            float bounceHeight = 20.0f;
-            float offset = bounceHeight * sin(progress * 3.14159f); // Full sine wave (0 to 1)
-            
-            animatingCard->setAnimationOffset(offset);
-        }
+    PROFILE_SCOPE("sim.update");
+    simArena.reset();
+    Uint64 tick = craftTimers.getCurrentTick();
+    journal.setTick(tick);
+    for (const SDL_Event& e : tickEvents) {
+        handleEvent(e);
     }
+    tickEvents.clear();
+    updateTweens();
     
     for (auto& card : cards) {
         card.update();
     }
+    
+    // Fire crafts whose timers expired this tick, then schedule crafts for changed stacks
+    PROFILE_SCOPE("sim.crafting");
+    expiredCrafts.clear();
+    craftTimers.advance(expiredCrafts);
+    std::sort(expiredCrafts.begin(), expiredCrafts.end()); // Deterministic completion order
+    for (Uint32 stackId : expiredCrafts) {
+        completeCraft(stackId);
+    }
     processRecipes();
+    
+    if (hashLog.isActive()) {
+        stateHash = hashSimulationState(tick - inputStartTick);
+        hashLog.record(tick - inputStartTick, stateHash);
+    }
 }
 
 void Game::render() {
+    captureSnapshot(frames[frontFrame]);
+    renderSnapshot(frames[frontFrame]);
+}
+
+void Game::captureSnapshot(FrameSnapshot& snapshot) {
+    PROFILE_SCOPE("render.capture");
+    snapshot.board = board;
+    snapshot.camera = camera;
+    
+    // Only cards on screen are snapshotted; the grid query finds them without visiting the rest, and
+    // the grid is only rebuilt after playmat cards moved or the vector changed
+    visibleCards.clear();
+    if (design->viewportCulling) {
+        SDL_FRect view = camera.getViewRect();
+        if (cardGridDirty) {
+            cardGrid.rebuild(cards);
+            cardGridDirty = false;
+        }
+        cardGrid.query(view, visibleCards);
+        // The dragged card moves every tick without dirtying the grid, so it may be filed elsewhere
+        if (draggingCard) visibleCards.push_back((Uint32)(draggingCard - cards.data()));
+        std::sort(visibleCards.begin(), visibleCards.end()); // Back to z-order
+        visibleCards.erase(std::unique(visibleCards.begin(), visibleCards.end()), visibleCards.end());
+        visibleCards.erase(std::remove_if(visibleCards.begin(), visibleCards.end(), [&](Uint32 index) {
+            const Card& card = cards[index];
+            SDL_FRect rect = {card.getPosition().x, card.getPosition().y - card.getAnimationOffset(),
+                              card.getSize().x, card.getSize().y};
+            return !SDL_HasRectIntersectionFloat(&rect, &view);
+        }), visibleCards.end());
+    } else {
+        for (Uint32 i = 0; i < (Uint32)cards.size(); i++) {
+            visibleCards.push_back(i);
+        }
+    }
+    
+    snapshot.cards.clear();
+    for (Uint32 index : visibleCards) {
+        const Card& card = cards[index];
+        Vector2 pos = card.getPosition();
+        Vector2 size = card.getSize();
+        CardSnapshot cs;
+        cs.rect = {pos.x, pos.y - card.getAnimationOffset(), size.x, size.y};
+        cs.type = card.getType();
+        cs.state = card.getState();
+        cs.id = card.getId();
+        cs.stackId = card.getStackId();
+        cs.count = card.getCount();
+        cs.highlighted = DEBUG_ENABLED && tweens.isActive(card.getId(), TweenProperty::LIFT);
+        cs.covered = false;
+        cs.impostor = -1;
+        snapshot.cards.push_back(cs);
+    }
+    snapshot.coveredEdge = {stackVisualOffsetX, stackVisualOffsetY};
+    analyzeStacks(snapshot);
+    
+    snapshot.handCards.clear();
+    for (const auto& card : handCards) {
+        Vector2 pos = card.getPosition();
+        Vector2 size = card.getSize();
+        CardSnapshot cs;
+        cs.rect = {pos.x, pos.y - card.getAnimationOffset(), size.x, size.y};
+        cs.type = card.getType();
+        cs.state = card.getState();
+        cs.id = card.getId();
+        cs.stackId = card.getStackId();
+        cs.count = card.getCount();
+        cs.highlighted = DEBUG_ENABLED && tweens.isActive(card.getId(), TweenProperty::LIFT);
+        cs.covered = false;
+        cs.impostor = -1;
+        snapshot.handCards.push_back(cs);
+    }
+    
+    snapshot.craftBars.clear();
+    Uint64 now = craftTimers.getCurrentTick();
+    for (const auto& entry : activeCrafts) {
+        const ActiveCraft& craft = entry.second;
+        float progress = (float)(now - craft.startTick) / (float)craft.durationTicks;
+        CraftBarSnapshot bar;
+        bar.rect = craft.barRect;
+        bar.progress = progress > 1.0f ? 1.0f : progress;
+        snapshot.craftBars.push_back(bar);
+    }
+    
+    snapshot.showHand = design->showHand;
+    snapshot.showStats = design->showDebugInfo;
+    snapshot.clipHand = !isDraggingFromHand;
+    snapshot.handClipTop = handArea.y - handHoverLift;
+    snapshot.lastClickPos = lastClickPos;
+    snapshot.tick = craftTimers.getCurrentTick();
+}
+
+void Game::analyzeStacks(FrameSnapshot& snapshot) {
+    // Walk each stack's members in z-order. A member whose successor sits exactly one stack step down
+    // and right is hidden except for an L-shaped edge, since the successor is drawn later; deep stacks
+    // then cost their visible pixels. Stacks whose members all form such a chain have settled and may
+    // be drawn from a cached impostor texture instead.
+    if (snapshotStackSlot.size() < nextCardId) {
+        snapshotStackSlot.reserve(nextCardId * 2); // Crafting keeps handing out ids
+        snapshotStackSlot.resize(nextCardId, -1);
+    }
+    std::vector<StackSnapshot>& stacks = snapshot.stacks;
+    stacks.clear();
+    const float epsilon = 0.01f;
+    for (int i = 0; i < (int)snapshot.cards.size(); i++) {
+        CardSnapshot& card = snapshot.cards[i];
+        int& slot = snapshotStackSlot[card.stackId];
+        if (slot == -1) {
+            slot = (int)stacks.size();
+            stacks.push_back({card.stackId, getStackVersion(card.stackId), (Uint32)i, (Uint32)i, 1, true, card.rect});
+            continue;
+        }
+        StackSnapshot& stack = stacks[slot];
+        CardSnapshot& lower = snapshot.cards[stack.top];
+        bool step = fabs(card.rect.x - lower.rect.x - stackVisualOffsetX) < epsilon &&
+                    fabs(card.rect.y - lower.rect.y - stackVisualOffsetY) < epsilon;
+        lower.covered = step && design->collapsedStacks;
+        stack.chained = stack.chained && step;
+        stack.top = (Uint32)i;
+        stack.count++;
+        SDL_GetRectUnionFloat(&stack.bounds, &card.rect, &stack.bounds);
+    }
+    for (const auto& card : snapshot.cards) {
+        snapshotStackSlot[card.stackId] = -1;
+    }
+    
+    // Keep the stacks worth an impostor. Cards of other stacks between the bottom and top member
+    // must not overlap it, since the texture draws every member at one point in the z-order.
+    const Uint32 minDepth = 3;
+    const Uint32 maxInterleaved = 64;
+    size_t kept = 0;
+    for (size_t s = 0; s < (design->stackImpostors ? stacks.size() : 0); s++) {
+        const StackSnapshot& stack = stacks[s];
+        Uint32 span = stack.top - stack.bottom + 1;
+        if (!stack.chained || stack.count < minDepth || span - stack.count > maxInterleaved) continue;
+        bool overlapped = false;
+        for (Uint32 i = stack.bottom + 1; i < stack.top && !overlapped; i++) {
+            const CardSnapshot& card = snapshot.cards[i];
+            overlapped = card.stackId != stack.stackId && SDL_HasRectIntersectionFloat(&card.rect, &stack.bounds);
+        }
+        if (overlapped) continue;
+        
+        for (Uint32 i = stack.bottom; i <= stack.top; i++) {
+            if (snapshot.cards[i].stackId == stack.stackId) snapshot.cards[i].impostor = (Sint32)kept;
+        }
+        stacks[kept++] = stack;
+    }
+    stacks.resize(kept);
+}
+
+Uint32 Game::getStackVersion(Uint32 stackId) const {
+    Uint32 version = (stackId < stackVersions.size()) ? stackVersions[stackId] : 0;
+    return (version != 0) ? version : stackVersionBase;
+}
+
+bool Game::drawImpostor(const FrameSnapshot& snapshot, const StackSnapshot& stack, RenderStats& stats) {
+    // Textures hold the stack at zoom 1; zoomed in they would be drawn blurred, so the cards are drawn instead
+    if (snapshot.camera.getZoom() > 1.0f) return false;
+    
+    SDL_FRect target = {stack.bounds.x, stack.bounds.y, std::ceil(stack.bounds.w), std::ceil(stack.bounds.h)};
+    ImpostorKey key = {stack.version, snapshot.cards[stack.bottom].id, stack.count};
+    SDL_Texture* texture = impostors.find(stack.stackId, key);
+    if (!texture) {
+        texture = impostors.beginBuild(renderer, stack.stackId, key, (int)target.w, (int)target.h);
+        if (!texture) return false; // Over this frame's build budget: draw the cards directly
+        for (Uint32 i = stack.bottom; i <= stack.top; i++) {
+            const CardSnapshot& card = snapshot.cards[i];
+            if (card.stackId != stack.stackId) continue;
+            SDL_FRect rect = {card.rect.x - stack.bounds.x, card.rect.y - stack.bounds.y, card.rect.w, card.rect.h};
+            if (card.covered) {
+                Card::renderEdge(renderer, colorManager, card.type, rect, snapshot.coveredEdge);
+            } else {
+                Card::renderFace(renderer, colorManager, card.type, rect);
+            }
+        }
+        impostors.endBuild();
+        stats.impostorBuilds++;
+    }
+    target = snapshot.camera.worldToScreen(target);
+    SDL_RenderTexture(renderer, texture, nullptr, &target);
+    stats.impostors++;
+    return true;
+}
+
+size_t Game::cullOccludedCards(const FrameSnapshot& snapshot, const SDL_FRect* rects, bool* culled) {
+    // Conservative coverage grid: a tile is marked only once opaque card pixels fill all of it.
+    // Walking front to back, a card is skipped when every tile it touches is marked; the grid
+    // covers the render output, which the player may have resized away from the design size.
+    const int tileSize = 32;
+    const float cornerRadius = 8.0f; // Rounded corners are not opaque; the cross between them is
+    int outputWidth = 0, outputHeight = 0;
+    SDL_GetRenderOutputSize(renderer, &outputWidth, &outputHeight);
+    int columns = (outputWidth + tileSize - 1) / tileSize;
+    int rows = (outputHeight + tileSize - 1) / tileSize;
+    if (columns <= 0 || rows <= 0) {
+        std::fill(culled, culled + snapshot.cards.size(), false);
+        return 0;
+    }
+    bool* tiles = renderArena.allocateArray<bool>((size_t)columns * rows);
+    std::fill(tiles, tiles + (size_t)columns * rows, false);
+    
+    auto markOpaque = [&](float x, float y, float w, float h) {
+        int tx0 = std::max(0, (int)std::ceil(x / tileSize));
+        int ty0 = std::max(0, (int)std::ceil(y / tileSize));
+        int tx1 = std::min(columns, (int)std::floor((x + w) / tileSize));
+        int ty1 = std::min(rows, (int)std::floor((y + h) / tileSize));
+        for (int ty = ty0; ty < ty1; ty++) {
+            std::fill(tiles + (size_t)ty * columns + tx0, tiles + (size_t)ty * columns + std::max(tx0, tx1), true);
+        }
+    };
+    
+    size_t occluded = 0;
+    for (int i = (int)snapshot.cards.size() - 1; i >= 0; i--) {
+        const SDL_FRect& rect = rects[i];
+        culled[i] = false;
+        int tx0 = std::max(0, (int)std::floor(rect.x / tileSize));
+        int ty0 = std::max(0, (int)std::floor(rect.y / tileSize));
+        int tx1 = std::min(columns - 1, (int)std::floor((rect.x + rect.w) / tileSize));
+        int ty1 = std::min(rows - 1, (int)std::floor((rect.y + rect.h) / tileSize));
+        if (tx0 > tx1 || ty0 > ty1) continue; // Off screen; not an occlusion question
+        
+        // Tiles clamped away say nothing about the part of the card beyond the grid
+        bool hidden = rect.x >= 0.0f && rect.y >= 0.0f &&
+                      rect.x + rect.w <= (float)(columns * tileSize) && rect.y + rect.h <= (float)(rows * tileSize);
+        for (int ty = ty0; ty <= ty1 && hidden; ty++) {
+            const bool* row = tiles + (size_t)ty * columns;
+            hidden = std::all_of(row + tx0, row + tx1 + 1, [](bool covered) { return covered; });
+        }
+        if (hidden) {
+            culled[i] = true;
+            occluded++;
+            continue;
+        }
+        // A covered stack member only draws its edge, so it hides nothing below it
+        if (snapshot.cards[i].covered) continue;
+        markOpaque(rect.x, rect.y + cornerRadius, rect.w, rect.h - 2 * cornerRadius);
+        markOpaque(rect.x + cornerRadius, rect.y, rect.w - 2 * cornerRadius, rect.h);
+    }
+    return occluded;
+}
+
+void Game::renderStatsOverlay(SDL_Renderer* renderer, const RenderStats& stats) {
+    char text[128];
+    int length = snprintf(text, sizeof(text), "cards %zu  drawn %zu  edges %zu  occluded %zu  impostors %zu (+%zu)",
+                          stats.cards, stats.cards - stats.occluded - stats.edges - stats.impostorCards, stats.edges,
+                          stats.occluded, stats.impostors, stats.impostorBuilds);
+    SDL_FRect background = {8.0f, 8.0f, length * 8.0f + 12.0f, 18.0f};
+    SDL_SetRenderDrawColor(renderer, 20, 20, 20, 200);
+    SDL_RenderFillRect(renderer, &background);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDebugText(renderer, background.x + 6.0f, background.y + 5.0f, text);
+}
+
+void Game::renderSnapshot(const FrameSnapshot& snapshot) {
+    PROFILE_SCOPE("render.draw");
+    renderArena.reset();
     // Use tan background color from config
     Color bgColor = colorManager.getBackgroundColor();
     SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
     SDL_RenderClear(renderer);
     
-    board.render(renderer, colorManager);
+    const Camera& camera = snapshot.camera;
+    snapshot.board.render(renderer, renderArena, colorManager, camera);
     
-    for (const auto& card : cards) {
-        card.render(renderer, colorManager);
+    // Everything below works on screen rects
+    SDL_FRect* rects = renderArena.allocateArray<SDL_FRect>(snapshot.cards.size());
+    for (size_t i = 0; i < snapshot.cards.size(); i++) {
+        rects[i] = camera.worldToScreen(snapshot.cards[i].rect);
+    }
+    SDL_FPoint coveredEdge = {snapshot.coveredEdge.x * camera.getZoom(), snapshot.coveredEdge.y * camera.getZoom()};
+    
+    RenderStats stats = {};
+    stats.cards = snapshot.cards.size();
+    bool* culled = renderArena.allocateArray<bool>(snapshot.cards.size());
+    if (design->occlusionCulling) {
+        stats.occluded = cullOccludedCards(snapshot, rects, culled);
+    } else {
+        std::fill(culled, culled + snapshot.cards.size(), false);
+    }
+    
+    // Per impostor stack: 0 until its first visible member, then 1 if drawn as a texture, 2 if card by card
+    Uint8* stackDrawn = renderArena.allocateArray<Uint8>(snapshot.stacks.size());
+    std::fill(stackDrawn, stackDrawn + snapshot.stacks.size(), 0);
+    
+    for (size_t i = 0; i < snapshot.cards.size(); i++) {
+        const CardSnapshot& card = snapshot.cards[i];
+        if (culled[i]) continue;
+        if (card.impostor >= 0) {
+            Uint8& drawn = stackDrawn[card.impostor];
+            if (drawn == 0) drawn = drawImpostor(snapshot, snapshot.stacks[card.impostor], stats) ? 1 : 2;
+            if (drawn == 1) {
+                stats.impostorCards++;
+                continue;
+            }
+        }
+        if (card.covered) {
+            Card::renderEdge(renderer, colorManager, card.type, rects[i], coveredEdge);
+            stats.edges++;
+            continue;
+        }
+        Card::renderFace(renderer, colorManager, card.type, rects[i]);
+        if (card.count > 1) renderCountBadge(renderer, rects[i], card.count);
     }
     
+    renderCraftProgress(renderer, snapshot);
+    
     // Render hand after playmat cards but before debug info (if enabled)
-    if (designManager.getShowHand()) {
-        renderHand(renderer);
+    if (snapshot.showHand) {
+        renderHand(renderer, snapshot);
     }
     
-    renderDebugInfo(renderer);
+    renderDebugInfo(renderer, snapshot);
+    if (snapshot.showStats) {
+        renderStatsOverlay(renderer, stats);
+    }
+    impostors.endFrame();
     
     SDL_RenderPresent(renderer);
 }
 
 void Game::initializeCards() {
-    cards.push_back(Card(CardType::VILLAGER, {100, 100}));
-    cards.push_back(Card(CardType::WOOD, {200, 100}));
-    cards.push_back(Card(CardType::ROCK, {300, 100}));
-    cards.push_back(Card(CardType::BERRY, {400, 100}));
-    cards.push_back(Card(CardType::BRANCH, {500, 100}));
-    cards.push_back(Card(CardType::LOG, {600, 100}));
-    cards.push_back(Card(CardType::PLANK, {700, 100}));
-    cards.push_back(Card(CardType::STICK, {800, 100}));
+    spawnCard(CardType::VILLAGER, {100, 100});
+    spawnCard(CardType::WOOD, {200, 100});
+    spawnCard(CardType::ROCK, {300, 100});
+    spawnCard(CardType::BERRY, {400, 100});
+    spawnCard(CardType::BRANCH, {500, 100});
+    spawnCard(CardType::LOG, {600, 100});
+    spawnCard(CardType::PLANK, {700, 100});
+    spawnCard(CardType::STICK, {800, 100});
 }
 
 void Game::initializeHand() {
@@ -213,61 +891,646 @@ void Game::initializeHand() {
     handCards.push_back(Card(CardType::LOG, {startX + 5 * handCardSpacing, y}));
     handCards.push_back(Card(CardType::PLANK, {startX + 6 * handCardSpacing, y}));
     handCards.push_back(Card(CardType::STICK, {startX + 7 * handCardSpacing, y}));
+    
+    // Hand cards get ids too so animations can target them
+    for (auto& card : handCards) {
+        card.setId(nextCardId++);
+        card.setStackId(card.getId());
+    }
+    handHoverLift = handCards[0].getSize().y / 2.0f;
 }
 
-void Game::initializeRecipes() {
-    Recipe recipe1 = {{CardType::VILLAGER, CardType::BERRY}, CardType::VILLAGER};
-    Recipe recipe2 = {{CardType::VILLAGER, CardType::WOOD}, CardType::VILLAGER};
-    Recipe recipe3 = {{CardType::BRANCH, CardType::ROCK}, CardType::STICK};
-    Recipe recipe4 = {{CardType::LOG, CardType::VILLAGER}, CardType::PLANK};
-    Recipe recipe5 = {{CardType::WOOD, CardType::WOOD}, CardType::LOG};
+void Game::loadContent() {
+    Uint64 startTime = SDL_GetTicksNS();
+    Uint64 sourceHash = ContentCache::hashSources({COLORS_CONFIG_PATH, DESIGN_CONFIG_PATH, GAME_CONFIG_PATH, RECIPES_CONFIG_PATH});
+    contentHash = sourceHash;
+    if (ContentCache::load(CONTENT_CACHE_PATH, sourceHash, colorManager, designManager, recipes)) {
+        printf("[CONTENT] Loaded compiled content from %s in %.2f ms\n", CONTENT_CACHE_PATH,
+               (SDL_GetTicksNS() - startTime) / 1000000.0);
+        return;
+    }
+    
+    // Cache missing or out of date: parse the text sources and compile them for next time
+    colorManager.loadFromFile(COLORS_CONFIG_PATH);
+    designManager.loadFromFile(DESIGN_CONFIG_PATH);
+    designManager.loadFromFile(GAME_CONFIG_PATH);
+    loadRecipes(RECIPES_CONFIG_PATH);
+    printf("[CONTENT] Parsed text content in %.2f ms\n", (SDL_GetTicksNS() - startTime) / 1000000.0);
     
-    recipes.push_back(recipe1);
-    recipes.push_back(recipe2);
-    recipes.push_back(recipe3);
-    recipes.push_back(recipe4);
-    recipes.push_back(recipe5);
+    if (!ContentCache::save(CONTENT_CACHE_PATH, sourceHash, colorManager, designManager, recipes)) {
+        printf("[CONTENT] Could not write %s\n", CONTENT_CACHE_PATH);
+    }
 }
 
-void Game::processRecipes() {
-    for (const auto& recipe : recipes) {
-        for (int i = 0; i < cards.size(); i++) {
-            for (int j = i + 1; j < cards.size(); j++) {
-                if (cards[i].getState() == CardState::IDLE && cards[j].getState() == CardState::IDLE) {
-                    bool matches = false;
-                    
-                    if ((cards[i].getType() == recipe.ingredients[0] && cards[j].getType() == recipe.ingredients[1]) ||
-                        (cards[i].getType() == recipe.ingredients[1] && cards[j].getType() == recipe.ingredients[0])) {
-                        
-                        Vector2 pos1 = cards[i].getPosition();
-                        Vector2 pos2 = cards[j].getPosition();
-                        Vector2 size = cards[i].getSize();
-                        
-                        float dx = pos1.x - pos2.x;
-                        float dy = pos1.y - pos2.y;
-                        float distance = sqrt(dx * dx + dy * dy);
-                        
-                        if (distance < 50.0f) {
-                            matches = true;
-                        }
-                    }
-                    
-                    if (matches) {
-                        Vector2 newPos = Vector2((cards[i].getPosition().x + cards[j].getPosition().x) / 2,
-                                                (cards[i].getPosition().y + cards[j].getPosition().y) / 2);
-                        
-                        cards.erase(cards.begin() + j);
-                        cards.erase(cards.begin() + i);
-                        
-                        cards.push_back(Card(recipe.result, newPos));
-                        return;
-                    }
-                }
+void Game::loadRecipes(const char* path) {
+    recipes.clear();
+    
+    std::string text;
+    JsonDocument document;
+    const JsonNode* list = nullptr;
+    if (readConfigFile(path, text) && document.parse(text)) {
+        list = document.find(document.getRoot(), "recipes");
+    }
+    
+    if (list && list->type == JsonType::ARRAY) {
+        for (const JsonNode* entry = document.firstChild(list); entry; entry = document.nextSibling(entry)) {
+            Recipe recipe;
+            recipe.craftTime = JsonDocument::asFloat(document.find(entry, "time"), 1.0f);
+            const JsonNode* result = document.find(entry, "result");
+            const JsonNode* ingredients = document.find(entry, "ingredients");
+            bool valid = result && Card::typeFromName(result->text, recipe.result) && recipe.craftTime >= 0.0f &&
+                         ingredients && ingredients->type == JsonType::ARRAY && ingredients->childCount > 0;
+            
+            for (const JsonNode* ingredient = document.firstChild(ingredients); valid && ingredient; ingredient = document.nextSibling(ingredient)) {
+                CardType type;
+                valid = Card::typeFromName(ingredient->text, type);
+                if (valid) recipe.ingredients.push_back(type);
+            }
+            
+            if (valid) {
+                recipes.push_back(recipe);
+            } else {
+                printf("[RECIPES] Skipping an invalid recipe in %s\n", path);
             }
         }
+    } else {
+        // Built-in recipes when the file is missing or broken
+        printf("[RECIPES] Could not load %s: %s, using defaults\n", path,
+               document.getError().empty() ? "no recipes array" : document.getError().c_str());
+        recipes.push_back({{CardType::VILLAGER, CardType::BERRY}, CardType::VILLAGER, 2.0f});
+        recipes.push_back({{CardType::VILLAGER, CardType::WOOD}, CardType::VILLAGER, 3.0f});
+        recipes.push_back({{CardType::BRANCH, CardType::ROCK}, CardType::STICK, 2.0f});
+        recipes.push_back({{CardType::LOG, CardType::VILLAGER}, CardType::PLANK, 4.0f});
+        recipes.push_back({{CardType::WOOD, CardType::WOOD}, CardType::LOG, 3.0f});
+    }
+    
+    // Ingredient order doesn't matter; keep them sorted for matching
+    for (auto& recipe : recipes) {
+        std::sort(recipe.ingredients.begin(), recipe.ingredients.end());
+    }
+}
+
+void Game::processRecipes() {
+    // Only stacks that changed since the last tick are evaluated; pending crafts cost nothing here
+    if (dirtyStacks.empty()) return;
+    
+    // Stack ids are unique and sorted so every mode schedules crafts in the same order
+    std::sort(dirtyStacks.begin(), dirtyStacks.end());
+    dirtyStacks.erase(std::unique(dirtyStacks.begin(), dirtyStacks.end()), dirtyStacks.end());
+    
+    // Candidates, their member types and their matches live in the frame arena
+    size_t candidateCount = dirtyStacks.size();
+    CraftCandidate* candidates = simArena.allocateArray<CraftCandidate>(candidateCount);
+    for (size_t i = 0; i < candidateCount; i++) {
+        // Any change to a stack restarts its craft
+        cancelCraft(dirtyStacks[i]);
+        
+        CraftCandidate candidate = {};
+        candidate.stackId = dirtyStacks[i];
+        candidate.recipeIndex = -1;
+        candidates[i] = candidate;
+    }
+    dirtyStacks.clear();
+    
+    // Candidates are sorted by stack id, so membership is a binary search (no per-tick hash nodes)
+    auto findCandidate = [candidates, candidateCount](Uint32 stackId) -> CraftCandidate* {
+        CraftCandidate* end = candidates + candidateCount;
+        CraftCandidate* it = std::lower_bound(candidates, end, stackId,
+                                              [](const CraftCandidate& c, Uint32 id) { return c.stackId < id; });
+        return (it != end && it->stackId == stackId) ? it : nullptr;
+    };
+    
+    // Gather each dirty stack's members into one flat type array (two passes over the board)
+    for (const auto& card : cards) {
+        CraftCandidate* found = findCandidate(card.getStackId());
+        if (!found) continue;
+        CraftCandidate& candidate = *found;
+        candidate.typeCount++;
+        if (card.getState() == CardState::DRAGGING || card.isPile()) candidate.busy = true;
+        candidate.base = card.getBasePosition();
+        candidate.cardWidth = card.getSize().x;
+    }
+    Uint32 offset = 0;
+    for (size_t i = 0; i < candidateCount; i++) {
+        candidates[i].firstType = offset;
+        offset += candidates[i].typeCount;
+        candidates[i].typeCount = 0;
+    }
+    CardType* candidateTypes = simArena.allocateArray<CardType>(offset);
+    for (const auto& card : cards) {
+        CraftCandidate* found = findCandidate(card.getStackId());
+        if (!found) continue;
+        CraftCandidate& candidate = *found;
+        candidateTypes[candidate.firstType + candidate.typeCount++] = card.getType();
+    }
+    
+    // Stacks are independent, so they can be matched concurrently; each job writes only its own candidates
+    auto evaluate = [this, candidates, candidateTypes](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            CraftCandidate& candidate = candidates[i];
+            if (candidate.busy || candidate.typeCount < 2) continue;
+            
+            CardType* types = &candidateTypes[candidate.firstType];
+            std::sort(types, types + candidate.typeCount);
+            candidate.recipeIndex = findRecipeIndex(types, candidate.typeCount);
+        }
+    };
+    if (design->parallelCrafting) {
+        jobs.parallelFor(candidateCount, 256, evaluate);
+    } else {
+        evaluate(0, candidateCount);
+    }
+    
+    // Apply on this thread in stack id order, so every mode schedules crafts identically
+    for (size_t i = 0; i < candidateCount; i++) {
+        const CraftCandidate& candidate = candidates[i];
+        if (candidate.recipeIndex == -1) continue;
+        
+        ActiveCraft craft;
+        craft.recipeIndex = candidate.recipeIndex;
+        craft.startTick = craftTimers.getCurrentTick();
+        craft.durationTicks = std::max((Uint64)1, (Uint64)(recipes[candidate.recipeIndex].craftTime * SIM_TICK_RATE)); // "time": 0 finishes next tick
+        craft.timer = craftTimers.schedule(craft.durationTicks, candidate.stackId);
+        
+        // Anchor the progress bar just above where the topmost card settles
+        int topIndex = (int)candidate.typeCount - 1;
+        Vector2 topPos = Vector2(candidate.base.x + topIndex * stackVisualOffsetX, candidate.base.y + topIndex * stackVisualOffsetY);
+        craft.barRect = {topPos.x, topPos.y - 12.0f, candidate.cardWidth, 8.0f};
+        activeCrafts[candidate.stackId] = craft;
+        recordCraftStart(candidate.stackId, craft);
+        
+        DEBUG_CARD("Craft scheduled on stack %u: recipe %d (%llu ticks)\n",
+                   candidate.stackId, candidate.recipeIndex, (unsigned long long)craft.durationTicks);
+    }
+}
+
+bool Game::saveGame(const std::string& path) {
+    Uint64 startTime = SDL_GetTicksNS();
+    SaveData data;
+    captureSave(data);
+    if (!writeSaveFile(path, data)) return false;
+    printf("[SAVE] Saved %zu cards to %s in %.2f ms\n", data.cards.size(), path.c_str(),
+           (SDL_GetTicksNS() - startTime) / 1000000.0);
+    return true;
+}
+
+bool Game::loadGame(const std::string& path) {
+    Uint64 startTime = SDL_GetTicksNS();
+    SaveData data;
+    if (!readSaveFile(path, data)) return false;
+    restoreSave(data);
+    resetUndoHistory();
+    printf("[SAVE] Loaded %zu cards from %s in %.2f ms\n", cards.size(), path.c_str(),
+           (SDL_GetTicksNS() - startTime) / 1000000.0);
+    return true;
+}
+
+static SaveCardRecord makeCardRecord(const Card& card) {
+    SaveCardRecord record;
+    record.id = card.getId();
+    record.stackId = card.getStackId();
+    record.type = (Uint32)card.getType();
+    record.count = card.getCount();
+    record.x = card.getPosition().x;
+    record.y = card.getPosition().y;
+    record.baseX = card.getBasePosition().x;
+    record.baseY = card.getBasePosition().y;
+    return record;
+}
+
+void Game::captureSave(SaveData& data) {
+    data.cards.resize(cards.size());
+    for (size_t i = 0; i < cards.size(); i++) {
+        // Cards sliding into a stack are saved where they will settle
+        SaveCardRecord& record = data.cards[i];
+        record = makeCardRecord(cards[i]);
+        record.x = tweens.getEndValue(record.id, TweenProperty::POSITION_X, record.x);
+        record.y = tweens.getEndValue(record.id, TweenProperty::POSITION_Y, record.y);
+    }
+    data.handCards.resize(handCards.size());
+    for (size_t i = 0; i < handCards.size(); i++) {
+        data.handCards[i] = makeCardRecord(handCards[i]);
+    }
+    
+    // One record per stack, in the z-order of its first card
+    data.stacks.clear();
+    saveStackIndex.clear();
+    for (const auto& card : cards) {
+        auto inserted = saveStackIndex.emplace(card.getStackId(), (Uint32)data.stacks.size());
+        if (inserted.second) {
+            SaveStackRecord stack = {};
+            stack.stackId = card.getStackId();
+            stack.recipeIndex = -1;
+            data.stacks.push_back(stack);
+        }
+        data.stacks[inserted.first->second].cardCount++;
+    }
+    
+    Uint64 now = craftTimers.getCurrentTick();
+    for (const auto& entry : activeCrafts) {
+        auto it = saveStackIndex.find(entry.first);
+        if (it == saveStackIndex.end()) continue;
+        const ActiveCraft& craft = entry.second;
+        SaveStackRecord& stack = data.stacks[it->second];
+        Uint64 elapsed = now - craft.startTick;
+        stack.recipeIndex = craft.recipeIndex;
+        stack.durationTicks = (Uint32)craft.durationTicks;
+        stack.remainingTicks = (Uint32)(elapsed < craft.durationTicks ? craft.durationTicks - elapsed : 1);
+        stack.barRect = craft.barRect;
+    }
+    
+    data.nextCardId = nextCardId;
+    data.tick = now;
+    data.journalSequence = journal.getSequence();
+}
+
+void Game::restoreSave(const SaveData& data) {
+    // Nothing may keep pointing into the old board
+    draggingCard = nullptr;
+    isDragging = false;
+    draggingHandCard = nullptr;
+    isDraggingFromHand = false;
+    hoveredHandCard = nullptr;
+    lastClickedCard = nullptr;
+    isOverStackTarget = false;
+    stackTargetIndex = -1;
+    tweens.clear();
+    craftTimers.clear();
+    activeCrafts.clear();
+    dirtyStacks.clear();
+    stackVersions.clear();
+    stackVersionBase = ++stackVersionCounter; // Every stack id may now name different cards
+    
+    cards.clear();
+    cards.reserve(data.cards.size());
+    for (const SaveCardRecord& record : data.cards) {
+        if (record.type >= (Uint32)CARD_TYPE_COUNT) continue;
+        Card card((CardType)record.type, Vector2(record.x, record.y));
+        card.setBasePosition(Vector2(record.baseX, record.baseY));
+        card.setId(record.id);
+        card.setStackId(record.stackId);
+        card.setCount(std::max(record.count, 1u));
+        cards.push_back(card);
+    }
+    handCards.clear();
+    handCards.reserve(data.handCards.size());
+    for (const SaveCardRecord& record : data.handCards) {
+        if (record.type >= (Uint32)CARD_TYPE_COUNT) continue;
+        Card card((CardType)record.type, Vector2(record.x, record.y));
+        card.setBasePosition(Vector2(record.baseX, record.baseY));
+        card.setId(record.id);
+        card.setStackId(record.stackId);
+        handCards.push_back(card);
+    }
+    cardIndexDirty = true;
+    cardGridDirty = true;
+    nextCardId = data.nextCardId;
+    fitBoardToCards();
+    
+    // Resume crafts where they left off; stacks with a stale recipe index are re-evaluated
+    Uint64 now = craftTimers.getCurrentTick();
+    for (const SaveStackRecord& stack : data.stacks) {
+        if (stack.recipeIndex >= 0 && stack.recipeIndex < (int)recipes.size() && stack.remainingTicks > 0) {
+            ActiveCraft craft;
+            craft.recipeIndex = stack.recipeIndex;
+            craft.durationTicks = std::max(1u, stack.durationTicks); // Saves from before crafts were clamped may hold 0
+            craft.startTick = now - (craft.durationTicks - std::min((Uint64)stack.remainingTicks, craft.durationTicks));
+            craft.barRect = stack.barRect;
+            craft.timer = craftTimers.schedule(stack.remainingTicks, stack.stackId);
+            activeCrafts[stack.stackId] = craft;
+        } else if (stack.cardCount > 1) {
+            markStackDirty(stack.stackId);
+        }
+    }
+    
+    // The journal can't express a wholesale replacement, so record the new board in full
+    if (journal.isActive()) {
+        JournalEntry reset = {};
+        reset.op = JournalOp::RESET;
+        journal.append(reset);
+        for (const auto& card : cards) {
+            recordCard(card, card.getPosition(), 0);
+        }
+        for (const auto& entry : activeCrafts) {
+            recordCraftStart(entry.first, entry.second);
+        }
+        journalSnapshotDue = true; // Those entries are the size of the board; a snapshot lets them be dropped
+    }
+}
+
+void Game::fitBoardToCards() {
+    // The board holds every card with some room to spare, and is never smaller than the window
+    const float margin = 100.0f;
+    float width = (float)design->windowWidth;
+    float height = (float)design->windowHeight;
+    for (const auto& card : cards) {
+        width = std::max(width, card.getBasePosition().x + card.getSize().x + margin);
+        height = std::max(height, card.getBasePosition().y + card.getSize().y + margin);
+    }
+    board.setSize(width, height);
+    camera.setBounds(board.getArea());
+}
+
+void Game::startJournal() {
+    // Without snapshots nothing would ever be compacted, so the journal would grow for the whole session
+    if (!design->journalEnabled || design->journalSnapshotSeconds <= 0.0f) return;
+    
+    std::string snapshotPath = Journal::snapshotPath(design->journalPath);
+    std::vector<std::string> segments = Journal::findSegments(design->journalPath);
+    if (!segments.empty() && options.loadPath.empty() && options.scenarioPath.empty()) {
+        // The last session didn't shut down cleanly: rebuild its board from the journal's snapshot and segments
+        SaveData data;
+        if (!readSaveFile(snapshotPath, data)) {
+            captureSave(data);
+        }
+        size_t applied = Journal::replay(segments, data);
+        restoreSave(data);
+        printf("[JOURNAL] Recovered %zu cards by replaying %zu entries on top of %s\n",
+               cards.size(), applied, snapshotPath.c_str());
+    }
+    
+    // This session's journal starts from a fresh snapshot of its own, which replaces the old segments;
+    // the player's autosave is left alone for --load
+    SaveData base;
+    captureSave(base);
+    if (!writeSaveFile(snapshotPath, base)) {
+        printf("[JOURNAL] No base snapshot could be written; journaling disabled\n");
+        return;
+    }
+    Journal::removeSegments(segments);
+    journal.start(design->journalPath);
+    lastJournalSnapshotTick = craftTimers.getCurrentTick();
+}
+
+void Game::recordCard(const Card& card, Vector2 position, Uint16 flags) {
+    if (flags & JOURNAL_STACK_ONLY) {
+        undoHistory.setStackId(card.getId(), card.getStackId());
+    } else {
+        undoHistory.setCard(card.getId(), card.getStackId(), card.getType(), card.getCount(), position, card.getBasePosition(),
+                            (flags & JOURNAL_TO_FRONT) != 0);
+    }
+    
+    if (!journal.isActive()) return;
+    JournalEntry entry = {};
+    entry.op = JournalOp::CARD;
+    entry.flags = flags;
+    entry.id = card.getId();
+    entry.stackId = card.getStackId();
+    entry.type = (Uint32)card.getType();
+    entry.count = card.getCount();
+    entry.x = position.x;
+    entry.y = position.y;
+    entry.baseX = card.getBasePosition().x;
+    entry.baseY = card.getBasePosition().y;
+    journal.append(entry);
+}
+
+void Game::recordErase(Uint32 cardId) {
+    undoHistory.eraseCard(cardId);
+    
+    if (!journal.isActive()) return;
+    JournalEntry entry = {};
+    entry.op = JournalOp::ERASE;
+    entry.id = cardId;
+    journal.append(entry);
+}
+
+void Game::recordCraftStart(Uint32 stackId, const ActiveCraft& craft) {
+    undoHistory.setCraft(stackId, craft.recipeIndex, (Uint32)craft.durationTicks,
+                         craft.startTick + craft.durationTicks, craft.barRect);
+    
+    if (!journal.isActive()) return;
+    JournalEntry entry = {};
+    entry.op = JournalOp::CRAFT_START;
+    entry.id = stackId;
+    entry.recipeIndex = craft.recipeIndex;
+    entry.durationTicks = (Uint32)craft.durationTicks;
+    entry.x = craft.barRect.x;
+    entry.y = craft.barRect.y;
+    entry.baseX = craft.barRect.w;
+    entry.baseY = craft.barRect.h;
+    journal.append(entry);
+}
+
+void Game::recordCraftEnd(Uint32 stackId) {
+    undoHistory.clearCraft(stackId);
+    
+    if (!journal.isActive()) return;
+    JournalEntry entry = {};
+    entry.op = JournalOp::CRAFT_END;
+    entry.id = stackId;
+    journal.append(entry);
+}
+
+void Game::resetUndoHistory() {
+    undoHistory.reset((size_t)std::max(design->undoLimit, 1));
+    for (const auto& card : cards) {
+        // Cards sliding into a stack are recorded where they will settle, as in captureSave
+        Vector2 rest(tweens.getEndValue(card.getId(), TweenProperty::POSITION_X, card.getPosition().x),
+                     tweens.getEndValue(card.getId(), TweenProperty::POSITION_Y, card.getPosition().y));
+        undoHistory.setCard(card.getId(), card.getStackId(), card.getType(), card.getCount(), rest,
+                            card.getBasePosition(), true);
+    }
+    for (const auto& entry : activeCrafts) {
+        const ActiveCraft& craft = entry.second;
+        undoHistory.setCraft(entry.first, craft.recipeIndex, (Uint32)craft.durationTicks,
+                             craft.startTick + craft.durationTicks, craft.barRect);
+    }
+}
+
+void Game::stepUndoHistory(bool forward) {
+    SaveData data;
+    Uint64 now = craftTimers.getCurrentTick();
+    if (!(forward ? undoHistory.redo(now, data) : undoHistory.undo(now, data))) return;
+    
+    // The hand is an infinite source and ids are never reused, so both stay as they are
+    for (const auto& card : handCards) {
+        data.handCards.push_back(makeCardRecord(card));
+    }
+    data.nextCardId = nextCardId;
+    data.tick = now;
+    
+    undoHistory.setRecording(false);
+    restoreSave(data);
+    undoHistory.setRecording(true);
+    printf("[UNDO] %s: %zu cards (%zu undo / %zu redo steps left)\n", forward ? "Redo" : "Undo", cards.size(),
+           undoHistory.getUndoCount(), undoHistory.getRedoCount());
+}
+
+Card& Game::spawnCard(CardType type, Vector2 pos) {
+    Card card(type, pos);
+    card.setId(nextCardId++);
+    card.setStackId(card.getId());
+    cards.push_back(card);
+    cardGridDirty = true;
+    if (!cardIndexDirty) {
+        if (card.getId() >= cardIndexById.size()) cardIndexById.resize(card.getId() + 1, -1);
+        cardIndexById[card.getId()] = (int)cards.size() - 1;
+    }
+    recordCard(card, pos, JOURNAL_TO_FRONT);
+    return cards.back();
+}
+
+int Game::findCardIndexById(Uint32 id) {
+    if (cardIndexDirty) {
+        if (nextCardId > cardIndexById.capacity()) cardIndexById.reserve(nextCardId * 2); // Crafting keeps handing out ids
+        cardIndexById.assign(nextCardId, -1);
+        for (int i = 0; i < (int)cards.size(); i++) {
+            Uint32 cardId = cards[i].getId();
+            if (cardId >= cardIndexById.size()) cardIndexById.resize(cardId + 1, -1);
+            cardIndexById[cardId] = i;
+        }
+        cardIndexDirty = false;
+    }
+    return (id < cardIndexById.size()) ? cardIndexById[id] : -1;
+}
+
+Card* Game::findCardById(Uint32 id) {
+    int index = findCardIndexById(id);
+    if (index != -1) return &cards[index];
+    for (auto& card : handCards) {
+        if (card.getId() == id) return &card;
+    }
+    return nullptr;
+}
+
+int Game::findRecipeIndex(const CardType* sortedTypes, size_t count) const {
+    // Recipes match on the exact multiset of card types in the stack (ingredients are pre-sorted)
+    for (int i = 0; i < (int)recipes.size(); i++) {
+        const std::vector<CardType>& ingredients = recipes[i].ingredients;
+        if (ingredients.size() == count && std::equal(ingredients.begin(), ingredients.end(), sortedTypes)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void Game::markStackDirty(Uint32 stackId) {
+    dirtyStacks.push_back(stackId);
+    bumpStackVersion(stackId);
+}
+
+void Game::bumpStackVersion(Uint32 stackId) {
+    // Any cached texture of this stack is now stale
+    if (stackId >= stackVersions.size()) {
+        if (stackId >= stackVersions.capacity()) stackVersions.reserve(std::max<size_t>(nextCardId * 2, stackId + 1));
+        stackVersions.resize(stackId + 1, 0);
+    }
+    stackVersions[stackId] = ++stackVersionCounter;
+}
+
+void Game::detachFromStack(Card* card) {
+    Uint32 oldStackId = card->getStackId();
+    Uint32 newRootId = 0;
+    
+    // Remaining members keep a stack of their own; if the root left, the next card becomes the root
+    for (auto& c : cards) {
+        if (&c == card || c.getStackId() != oldStackId) continue;
+        if (oldStackId == card->getId()) {
+            if (newRootId == 0) newRootId = c.getId();
+            c.setStackId(newRootId);
+            recordCard(c, c.getPosition(), JOURNAL_STACK_ONLY); // May still be sliding into place
+        }
+    }
+    
+    card->setStackId(card->getId());
+    recordCard(*card, card->getPosition(), JOURNAL_TO_FRONT); // Picked up cards were brought to the front
+    if (oldStackId != card->getId() || newRootId != 0) {
+        cancelCraft(oldStackId);
+        markStackDirty(newRootId != 0 ? newRootId : oldStackId);
+    }
+    if (newRootId != 0) {
+        bumpStackVersion(oldStackId); // The picked up root keeps the old id for a stack of one
+    }
+}
+
+void Game::cancelCraft(Uint32 stackId) {
+    auto it = activeCrafts.find(stackId);
+    if (it == activeCrafts.end()) return;
+    craftTimers.cancel(it->second.timer);
+    activeCrafts.erase(it);
+    recordCraftEnd(stackId);
+    DEBUG_CARD("Craft cancelled on stack %u\n", stackId);
+}
+
+void Game::completeCraft(Uint32 stackId) {
+    auto it = activeCrafts.find(stackId);
+    if (it == activeCrafts.end()) return;
+    const Recipe& recipe = recipes[it->second.recipeIndex];
+    activeCrafts.erase(it);
+    recordCraftEnd(stackId);
+    
+    // Remember drag targets by id; erasing cards invalidates pointers and indices
+    Uint32 draggingId = draggingCard ? draggingCard->getId() : 0;
+    Uint32 targetId = (stackTargetIndex != -1) ? cards[stackTargetIndex].getId() : 0;
+    
+    Vector2 anchor;
+    bool found = false;
+    for (const auto& card : cards) {
+        if (card.getStackId() == stackId) {
+            anchor = card.getBasePosition();
+            found = true;
+            break;
+        }
+    }
+    if (!found) return;
+    
+    for (const auto& card : cards) {
+        if (card.getStackId() == stackId) recordErase(card.getId());
+    }
+    cards.erase(std::remove_if(cards.begin(), cards.end(),
+                               [stackId](const Card& c) { return c.getStackId() == stackId; }),
+                cards.end());
+    cardIndexDirty = true;
+    cardGridDirty = true;
+    Card& result = spawnCard(recipe.result, anchor);
+    markStackDirty(result.getStackId());
+    
+    // Pop the result card to show the craft finished
+    result.setState(CardState::ANIMATING);
+    tweens.start(result.getId(), TweenProperty::LIFT, 0.0f, 15.0f, pickupDuration, Easing::ARC);
+    
+    DEBUG_CARD("Craft completed on stack %u: result type %d\n", stackId, (int)recipe.result);
+    
+    lastClickedCard = nullptr;
+    if (draggingId != 0) {
+        int idx = findCardIndexById(draggingId);
+        draggingCard = (idx != -1) ? &cards[idx] : nullptr;
+        if (!draggingCard) isDragging = false;
+    }
+    if (targetId != 0) {
+        stackTargetIndex = findCardIndexById(targetId);
+        isOverStackTarget = (stackTargetIndex != -1);
+    }
+}
+
+void Game::renderCraftProgress(SDL_Renderer* renderer, const FrameSnapshot& snapshot) {
+    Color background = colorManager.getProgressBackground();
+    Color fill = colorManager.getProgressBar();
+    
+    for (const auto& bar : snapshot.craftBars) {
+        SDL_FRect rect = snapshot.camera.worldToScreen(bar.rect);
+        SDL_SetRenderDrawColor(renderer, background.r, background.g, background.b, background.a);
+        SDL_RenderFillRect(renderer, &rect);
+        
+        SDL_FRect filled = {rect.x, rect.y, rect.w * bar.progress, rect.h};
+        SDL_SetRenderDrawColor(renderer, fill.r, fill.g, fill.b, fill.a);
+        SDL_RenderFillRect(renderer, &filled);
     }
 }
 
+void Game::renderCountBadge(SDL_Renderer* renderer, SDL_FRect rect, Uint32 count) {
+    // Pile size in the top-right corner; the debug font is 8x8 pixels per glyph
+    char text[16];
+    int length = snprintf(text, sizeof(text), "%u", count);
+    float width = length * 8.0f + 8.0f;
+    SDL_FRect badge = {rect.x + rect.w - width - 4.0f, rect.y + 4.0f, width, 14.0f};
+    SDL_SetRenderDrawColor(renderer, 20, 20, 20, 220);
+    SDL_RenderFillRect(renderer, &badge);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDebugText(renderer, badge.x + 4.0f, badge.y + 3.0f, text);
+}
+
 Card* Game::getCardAt(Vector2 pos) {
     for (int i = cards.size() - 1; i >= 0; i--) {
         if (cards[i].containsPoint(pos)) {
@@ -283,77 +1546,148 @@ void Game::bringCardToFront(Card* card) {
             Card temp = cards[i];
             cards.erase(cards.begin() + i);
             cards.push_back(temp);
+            cardIndexDirty = true;
+            cardGridDirty = true;
             break;
         }
     }
 }
 
 void Game::startPickupAnimation(Card* card) {
-    // Stop any existing animation
-    if (animatingCard) {
-        animatingCard->setAnimationOffset(0.0f);
-        animatingCard->setState(CardState::IDLE);
-    }
+    if (!design->enablePickupAnimation) return;
     
-    // Start new animation
-    animatingCard = card;
-    animationTimer = 0.0f;
+    // Bounce up and back down along a half sine
+    float bounceHeight = 20.0f;
+    tweens.start(card->getId(), TweenProperty::LIFT, 0.0f, bounceHeight, pickupDuration, Easing::ARC);
     card->setState(CardState::ANIMATING);
     
     DEBUG_ANIMATION("Starting animation for card type: %d\n", (int)card->getType());
 }
 
-void Game::renderDebugInfo(SDL_Renderer* renderer) {
+void Game::markCardMoved(const Card* card) {
+    // Hand cards are not in the grid, and captureSnapshot tests the dragged card on its own
+    if (card == draggingCard) return;
+    if (card >= cards.data() && card < cards.data() + cards.size()) cardGridDirty = true;
+}
+
+void Game::animateLift(Card* card, float to) {
+    if (!design->enableDragAnimation) {
+        tweens.cancel(card->getId(), TweenProperty::LIFT);
+        card->setAnimationOffset(to);
+        markCardMoved(card);
+        return;
+    }
+    tweens.start(card->getId(), TweenProperty::LIFT, card->getAnimationOffset(), to, liftDuration, Easing::EASE_OUT_QUAD);
+}
+
+void Game::animateHover(Card* card, float to) {
+    if (!design->enableCardHover) return;
+    tweens.start(card->getId(), TweenProperty::LIFT, card->getAnimationOffset(), to, liftDuration, Easing::EASE_OUT_QUAD);
+}
+
+void Game::animateMove(Card* card, Vector2 to) {
+    Vector2 from = card->getPosition();
+    tweens.start(card->getId(), TweenProperty::POSITION_X, from.x, to.x, relayoutDuration, Easing::EASE_IN_OUT_CUBIC);
+    tweens.start(card->getId(), TweenProperty::POSITION_Y, from.y, to.y, relayoutDuration, Easing::EASE_IN_OUT_CUBIC);
+}
+
+void Game::updateTweens() {
+    // Advance every animation in parallel chunks, then write the values back to their cards
+    // serially (an X and a Y tween can target the same card)
+    float dt = SIM_TICK_SECONDS * design->animationSpeed;
+    jobs.parallelFor(tweens.size(), 4096, [this, dt](size_t begin, size_t end) {
+        tweens.updateRange(begin, end, dt);
+    });
+    
+    for (size_t i = 0; i < tweens.size(); i++) {
+        Card* card = findCardById(tweens.getTarget(i));
+        if (!card) {
+            tweens.kill(i); // Card was consumed by a craft
+            continue;
+        }
+        
+        float value = tweens.getValue(i);
+        Vector2 pos = card->getPosition();
+        switch (tweens.getProperty(i)) {
+            case TweenProperty::LIFT:
+                card->setAnimationOffset(value);
+                markCardMoved(card);
+                if (tweens.isFinished(i) && card->getState() == CardState::ANIMATING && card != hoveredHandCard) {
+                    card->setState(CardState::IDLE);
+                }
+                break;
+            case TweenProperty::POSITION_X:
+                card->setPosition(Vector2(value, pos.y));
+                markCardMoved(card);
+                break;
+            case TweenProperty::POSITION_Y:
+                card->setPosition(Vector2(pos.x, value));
+                markCardMoved(card);
+                break;
+        }
+    }
+    
+    tweens.removeFinished();
+}
+
+void Game::renderDebugInfo(SDL_Renderer* renderer, const FrameSnapshot& snapshot) {
 #ifdef DEBUG_MODE
     // Draw red cross at last click position
-    if (lastClickPos.x != 0 || lastClickPos.y != 0) {
+    Vector2 clickPos = snapshot.lastClickPos;
+    if (clickPos.x != 0 || clickPos.y != 0) {
         Color clickColor = colorManager.getClickIndicator();
         SDL_SetRenderDrawColor(renderer, clickColor.r, clickColor.g, clickColor.b, clickColor.a);
         
         // Draw a cross at click position
         for (int i = -5; i <= 5; i++) {
-            SDL_RenderPoint(renderer, lastClickPos.x + i, lastClickPos.y);
-            SDL_RenderPoint(renderer, lastClickPos.x, lastClickPos.y + i);
+            SDL_RenderPoint(renderer, clickPos.x + i, clickPos.y);
+            SDL_RenderPoint(renderer, clickPos.x, clickPos.y + i);
         }
     }
     
-    // Highlight the currently animating card with a border
-    if (animatingCard) {
-        Color animColor = colorManager.getAnimationBorder();
-        SDL_SetRenderDrawColor(renderer, animColor.r, animColor.g, animColor.b, animColor.a);
-        Vector2 pos = animatingCard->getPosition();
-        Vector2 size = animatingCard->getSize();
-        float offset = animatingCard->getAnimationOffset();
-        
-        SDL_FRect rect = {pos.x - 2, pos.y - offset - 2, size.x + 4, size.y + 4};
-        SDL_RenderRect(renderer, &rect);
-    }
-    
-    // Highlight the currently dragging card with a border
-    if (draggingCard) {
-        Color dragColor = colorManager.getDragBorder();
-        SDL_SetRenderDrawColor(renderer, dragColor.r, dragColor.g, dragColor.a);
-        Vector2 pos = draggingCard->getPosition();
-        Vector2 size = draggingCard->getSize();
-        float offset = draggingCard->getAnimationOffset();
+    Color animColor = colorManager.getAnimationBorder();
+    Color dragColor = colorManager.getDragBorder();
+    for (const auto& card : snapshot.cards) {
+        SDL_FRect screen = snapshot.camera.worldToScreen(card.rect);
+        // Highlight every card with a running lift animation
+        if (card.highlighted) {
+            SDL_SetRenderDrawColor(renderer, animColor.r, animColor.g, animColor.b, animColor.a);
+            SDL_FRect rect = {screen.x - 2, screen.y - 2, screen.w + 4, screen.h + 4};
+            SDL_RenderRect(renderer, &rect);
+        }
         
-        SDL_FRect rect = {pos.x - 3, pos.y - offset - 3, size.x + 6, size.y + 6};
-        SDL_RenderRect(renderer, &rect);
+        // Highlight the currently dragging card with a border
+        if (card.state == CardState::DRAGGING) {
+            SDL_SetRenderDrawColor(renderer, dragColor.r, dragColor.g, dragColor.b, dragColor.a);
+            SDL_FRect rect = {screen.x - 3, screen.y - 3, screen.w + 6, screen.h + 6};
+            SDL_RenderRect(renderer, &rect);
+        }
     }
+#else
+    (void)renderer; (void)snapshot;
 #endif
 }
 
-void Game::startDrag(Card* card, Vector2 mousePos) {
-    // Stop any existing animation
-    if (animatingCard) {
-        animatingCard->setAnimationOffset(0.0f);
-        animatingCard->setState(CardState::IDLE);
-        animatingCard = nullptr;
+void Game::pickUpCard(Card* card, Vector2 mousePos, bool wholePile) {
+    undoHistory.beginAction();
+    if (card->isPile() && !wholePile) {
+        card = &splitPile(card);
     }
-    
+    lastClickedCard = card;
+    bringCardToFront(card);
+    startDrag(card, mousePos);
+}
+
+void Game::startDrag(Card* card, Vector2 mousePos) {
     // Update card pointer after potential reordering in bringCardToFront
     card = &cards.back(); // The card is now at the end of the vector
     
+    // Stop any running animation; the mouse owns the card's position from here
+    tweens.cancelAll(card->getId());
+    
+    // Picking a card up breaks its stack and cancels any craft running on it
+    detachFromStack(card);
+    
     // Calculate drag offset (how far the mouse is from the card's top-left corner)
     Vector2 cardPos = card->getPosition();
     dragOffset = Vector2(mousePos.x - cardPos.x, mousePos.y - cardPos.y);
@@ -364,7 +1698,7 @@ void Game::startDrag(Card* card, Vector2 mousePos) {
     
     // Set card to dragging state with lift effect
     card->setState(CardState::DRAGGING);
-    card->setAnimationOffset(20.0f); // Lift the card up
+    animateLift(card, 20.0f); // Lift the card up
     
     // Reset stacking state while starting drag
     isOverStackTarget = false;
@@ -380,22 +1714,23 @@ void Game::updateDrag(Vector2 mousePos) {
         draggingCard->setPosition(newPos);
 
         // If stacking is enabled, check if we're overlapping another card enough to snap/stack
-        if (designManager.getEnableCardStacking()) {
+        if (design->enableCardStacking) {
             int targetIdx = findOverlapTargetIndex(draggingCard, stackOverlapThreshold);
             if (targetIdx != -1) {
-                // Check stack size limit
+                // Check stack size limit and pile rules
                 Vector2 targetBase = cards[targetIdx].getBasePosition();
                 int currentStack = getStackCountAtBasePosition(targetBase);
-                if (currentStack < designManager.getMaxStackSize()) {
+                DropAction action = classifyDrop(targetIdx, *draggingCard);
+                if (action != DropAction::NONE) {
                     isOverStackTarget = true;
                     stackTargetIndex = targetIdx;
 
-                    // Snap visually to top of stack (downwards and to the right)
-                    int snapIndex = currentStack; // new card will be the topmost (0-based)
+                    // Snap visually to top of stack (downwards and to the right); a merge lands on the pile itself
+                    int snapIndex = (action == DropAction::MERGE) ? 0 : currentStack; // new card will be the topmost (0-based)
                     Vector2 snapPos = Vector2(targetBase.x + (snapIndex * stackVisualOffsetX), targetBase.y + (snapIndex * stackVisualOffsetY));
                     draggingCard->setPosition(snapPos);
                 } else {
-                    // Stack full - do not snap
+                    // Stack full or a pile of another type - do not snap
                     isOverStackTarget = false;
                     stackTargetIndex = -1;
                 }
@@ -409,23 +1744,32 @@ void Game::updateDrag(Vector2 mousePos) {
 
 void Game::stopDrag() {
     if (draggingCard && isDragging) {
+        // The grid still has the card where the drag began
+        cardGridDirty = true;
+
         // Drop the card down
-        draggingCard->setAnimationOffset(0.0f);
+        animateLift(draggingCard, 0.0f);
         draggingCard->setState(CardState::IDLE);
         
         DEBUG_DRAG("Drag stopped for card type: %d\n", (int)draggingCard->getType());
         
         // If we were snapping to a stack target, finalize the stacking
-        if (isOverStackTarget && stackTargetIndex != -1 && designManager.getEnableCardStacking()) {
+        bool stacked = false;
+        if (isOverStackTarget && stackTargetIndex != -1 && design->enableCardStacking) {
             // Find source index of draggingCard in the vector
             int sourceIndex = -1;
             for (int i = 0; i < cards.size(); i++) {
                 if (&cards[i] == draggingCard) { sourceIndex = i; break; }
             }
             if (sourceIndex != -1) {
-                finalizeStacking(stackTargetIndex, sourceIndex);
+                stacked = finalizeStacking(stackTargetIndex, sourceIndex);
             }
         }
+        if (!stacked) {
+            // Dropped loose, or the stack refused it: the card now anchors its own stack where it landed
+            draggingCard->setBasePosition(draggingCard->getPosition());
+            recordCard(*draggingCard, draggingCard->getPosition(), JOURNAL_TO_FRONT);
+        }
         
         // Clear drag state
         draggingCard = nullptr;
@@ -452,25 +1796,35 @@ void Game::startHandCardDrag(Card* handCard, Vector2 mousePos) {
     
     // Set card to dragging state with lift effect
     handCard->setState(CardState::DRAGGING);
-    handCard->setAnimationOffset(20.0f); // Lift the card up
+    animateLift(handCard, 20.0f); // Lift the card up (from the hover height if hovered)
     
     DEBUG_DRAG("Hand card drag started with offset: (%.1f, %.1f)\n", dragOffset.x, dragOffset.y);
 }
 
+void Game::followCamera() {
+    // The camera moved under a still cursor; whatever is being dragged stays under it
+    if (isDraggingFromHand) {
+        updateHandCardDrag(lastMousePos);
+    } else if (isDragging) {
+        updateDrag(camera.screenToWorld(lastMousePos));
+    }
+}
+
 void Game::stopHandCardDrag() {
     if (draggingHandCard && isDraggingFromHand) {
-        float mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
-        Vector2 currentMousePos = Vector2(mouseX, mouseY);
+        // Use the position from the button-up event (SDL input state belongs to the main thread)
+        Vector2 currentMousePos = lastMousePos;
         
         if (isOverPlaymat(currentMousePos)) {
             // Drop on playmat - create new card and reset hand card position
-            Vector2 dropPos = draggingHandCard->getPosition();
+            Vector2 dropPos = camera.screenToWorld(draggingHandCard->getPosition());
 
-            if (isOverStackTarget && stackTargetIndex != -1 && designManager.getEnableCardStacking()) {
+            if (isOverStackTarget && stackTargetIndex != -1 && design->enableCardStacking) {
                 // If stacking target exists, and under limit, create new card and finalize stacking
                 // Create the new card at dropPos and append to cards
-                cards.push_back(Card(draggingHandCard->getType(), dropPos));
+                Card& played = spawnCard(draggingHandCard->getType(), dropPos);
+                played.setAnimationOffset(draggingHandCard->getAnimationOffset());
+                animateLift(&played, 0.0f);
                 int sourceIndex = (int)cards.size() - 1;
                 finalizeStacking(stackTargetIndex, sourceIndex);
                 DEBUG_DRAG("Hand card stacked on existing stack at index %d\n", stackTargetIndex);
@@ -484,6 +1838,7 @@ void Game::stopHandCardDrag() {
         
         // Return hand card to original position and state
         draggingHandCard->setPosition(handCardOriginalPos);
+        tweens.cancel(draggingHandCard->getId(), TweenProperty::LIFT);
         draggingHandCard->setAnimationOffset(0.0f);
         draggingHandCard->setState(CardState::IDLE);
         
@@ -518,37 +1873,38 @@ void Game::updateHandHover(Vector2 mousePos) {
     if (newHoveredCard != hoveredHandCard) {
         // Reset previous hovered card
         if (hoveredHandCard) {
-            hoveredHandCard->setAnimationOffset(0.0f);
+            animateHover(hoveredHandCard, 0.0f);
             hoveredHandCard->setState(CardState::IDLE);
         }
         
         // Set new hovered card
         hoveredHandCard = newHoveredCard;
         if (hoveredHandCard) {
-            hoveredHandCard->setAnimationOffset(66.0f); // Rise up by 66px (half the card height)
+            animateHover(hoveredHandCard, handHoverLift);
             hoveredHandCard->setState(CardState::ANIMATING);
             DEBUG_PRINT("Hand card hovered: type %d\n", (int)hoveredHandCard->getType());
         }
     }
 }
 
-void Game::renderHand(SDL_Renderer* renderer) {
+void Game::renderHand(SDL_Renderer* renderer, const FrameSnapshot& snapshot) {
     // Only set clipping rectangle if we're not dragging a hand card
     // This allows the dragged card to be visible anywhere on screen
-    if (!isDraggingFromHand) {
+    if (snapshot.clipHand) {
         // Set clipping rectangle to allow full card visibility when hovered
-        // Cards start at y=1014, hover to y=948, so clip from y=948
-        SDL_Rect clipRect = {0, 948, 1920, 132}; // Show from y=948 to bottom of screen
+        // Clip from the hover height (y=948 for the default hand) to the bottom of the screen
+        int clipTop = (int)snapshot.handClipTop;
+        SDL_Rect clipRect = {0, clipTop, 1920, 1080 - clipTop};
         SDL_SetRenderClipRect(renderer, &clipRect);
     }
     
     // Render all hand cards
-    for (const auto& card : handCards) {
-        card.render(renderer, colorManager);
+    for (const auto& card : snapshot.handCards) {
+        Card::renderFace(renderer, colorManager, card.type, card.rect);
     }
     
     // Remove clipping for rest of the rendering (only if we set it)
-    if (!isDraggingFromHand) {
+    if (snapshot.clipHand) {
         SDL_SetRenderClipRect(renderer, nullptr);
     }
 }
@@ -556,9 +1912,10 @@ void Game::renderHand(SDL_Renderer* renderer) {
 void Game::playCardFromHand(Card* handCard, Vector2 position) {
     if (!handCard) return;
     
-    // Create a new card on the playmat
-    Card newCard(handCard->getType(), position);
-    cards.push_back(newCard);
+    // Create a new card on the playmat, dropping from the hand card's lift height
+    Card& played = spawnCard(handCard->getType(), position);
+    played.setAnimationOffset(handCard->getAnimationOffset());
+    animateLift(&played, 0.0f);
     
     // Note: In a full game, we might remove the card from hand or have limited uses
     // For now, we keep the hand card as an infinite source
@@ -567,12 +1924,17 @@ void Game::playCardFromHand(Card* handCard, Vector2 position) {
 }
 
 // Stacking helper implementations
+bool Game::isStackMemberAt(const Card& card, const Vector2& basePos) const {
+    // Stacks are the cards sharing a base position, except a pile left lying there (piles never join stacks)
+    const float epsilon = 0.1f;
+    Vector2 bp = card.getBasePosition();
+    return !card.isPile() && fabs(bp.x - basePos.x) < epsilon && fabs(bp.y - basePos.y) < epsilon;
+}
+
 int Game::getStackCountAtBasePosition(const Vector2& basePos) const {
     int count = 0;
-    const float epsilon = 0.1f;
     for (const auto& c : cards) {
-        Vector2 bp = c.getBasePosition();
-        if (fabs(bp.x - basePos.x) < epsilon && fabs(bp.y - basePos.y) < epsilon) {
+        if (isStackMemberAt(c, basePos)) {
             count++;
         }
     }
@@ -616,19 +1978,22 @@ int Game::findOverlapTargetIndex(const Card* sourceCard, float requiredFraction)
     return -1;
 }
 
-void Game::finalizeStacking(int targetIndex, int sourceIndex) {
-    if (targetIndex < 0 || sourceIndex < 0 || targetIndex >= (int)cards.size() || sourceIndex >= (int)cards.size()) return;
-    if (targetIndex == sourceIndex) return;
-
-    // Determine the base position of the target stack
-    Vector2 targetBase = cards[targetIndex].getBasePosition();
+bool Game::finalizeStacking(int targetIndex, int sourceIndex) {
+    if (targetIndex < 0 || sourceIndex < 0 || targetIndex >= (int)cards.size() || sourceIndex >= (int)cards.size()) return false;
+    if (targetIndex == sourceIndex) return false;
 
-    // Count current cards in the stack
-    int currentStack = getStackCountAtBasePosition(targetBase);
-    if (currentStack >= designManager.getMaxStackSize()) {
-        return; // Stack is full
+    // Rules may have changed since the drag snapped (a craft finished); a full stack is NONE
+    DropAction action = classifyDrop(targetIndex, cards[sourceIndex]);
+    if (action == DropAction::NONE) return false;
+    if (action == DropAction::MERGE) {
+        mergeIntoPile(targetIndex, sourceIndex);
+        return true;
     }
 
+    // Determine the base position and id of the target stack
+    Vector2 targetBase = cards[targetIndex].getBasePosition();
+    Uint32 targetStackId = cards[targetIndex].getStackId();
+
     // Extract the source card
     Card temp = cards[sourceIndex];
 
@@ -643,46 +2008,131 @@ void Game::finalizeStacking(int targetIndex, int sourceIndex) {
 
     // Append the card to the end so it becomes topmost
     cards.push_back(temp);
+    cardIndexDirty = true;
+    cardGridDirty = true;
 
     // Recalculate stack ordering and visual offsets for all cards sharing the same base position
-    std::vector<int> stackIndices;
-    const float epsilon = 0.1f;
+    int* stackIndices = simArena.allocateArray<int>(cards.size());
+    int stackCount = 0;
     for (int i = 0; i < (int)cards.size(); i++) {
-        Vector2 bp = cards[i].getBasePosition();
-        if (fabs(bp.x - targetBase.x) < epsilon && fabs(bp.y - targetBase.y) < epsilon) {
-            stackIndices.push_back(i);
-            // Ensure the base position is consistent
+        if (isStackMemberAt(cards[i], targetBase)) {
+            stackIndices[stackCount++] = i;
+            // Ensure the base position and stack id are consistent
             cards[i].setBasePosition(targetBase);
+            cards[i].setStackId(targetStackId);
         }
     }
 
     // Apply visual offsets based on stack order (bottom -> top)
-    for (int k = 0; k < (int)stackIndices.size(); k++) {
+    for (int k = 0; k < stackCount; k++) {
         int idx = stackIndices[k];
         Vector2 pos = Vector2(targetBase.x + (k * stackVisualOffsetX), targetBase.y + (k * stackVisualOffsetY));
-        cards[idx].setPosition(pos);
+        Vector2 current = cards[idx].getPosition();
+        if (fabs(current.x - pos.x) > 0.5f || fabs(current.y - pos.y) > 0.5f) {
+            animateMove(&cards[idx], pos); // Slide into place
+        } else {
+            cards[idx].setPosition(pos);
+        }
+        // Journal where the card settles; the stacked card is the one that moved to the front
+        recordCard(cards[idx], pos, idx == (int)cards.size() - 1 ? JOURNAL_TO_FRONT : 0);
+    }
+    
+    // Membership changed: re-evaluate recipes for this stack on the next tick
+    markStackDirty(targetStackId);
+    return true;
+}
+
+DropAction Game::classifyDrop(int targetIndex, const Card& source) const {
+    Uint32 stackId = cards[targetIndex].getStackId();
+    int members = 0;
+    bool identical = true;
+    bool pile = source.isPile();
+    for (const auto& card : cards) {
+        if (card.getStackId() != stackId || &card == &source) continue;
+        members++;
+        identical = identical && card.getType() == source.getType();
+        pile = pile || card.isPile();
+    }
+    
+    // Piles only ever join identical cards, and nothing is stacked on top of one
+    if (!identical) {
+        return (!pile && members < design->maxStackSize) ? DropAction::STACK : DropAction::NONE;
+    }
+    if (pile) return DropAction::MERGE;
+    
+    // Identical single cards stack while they still make a recipe (two wood craft a log) and pile up otherwise
+    int size = members + 1;
+    for (const Recipe& recipe : recipes) {
+        if ((int)recipe.ingredients.size() == size &&
+            std::all_of(recipe.ingredients.begin(), recipe.ingredients.end(),
+                        [&source](CardType type) { return type == source.getType(); })) {
+            return (members < design->maxStackSize) ? DropAction::STACK : DropAction::MERGE;
+        }
     }
+    return DropAction::MERGE;
+}
+
+void Game::mergeIntoPile(int targetIndex, int sourceIndex) {
+    // The target stack's root card absorbs the other members and the dropped card, which leave the board
+    Uint32 stackId = cards[targetIndex].getStackId();
+    Uint32 sourceId = cards[sourceIndex].getId();
+    auto absorbed = [stackId, sourceId](const Card& c) {
+        return (c.getStackId() == stackId && c.getId() != stackId) || c.getId() == sourceId;
+    };
+    
+    Uint32 total = 0;
+    for (const auto& card : cards) {
+        if (card.getStackId() == stackId || card.getId() == sourceId) total += card.getCount();
+    }
+    cancelCraft(stackId);
+    for (const auto& card : cards) {
+        if (absorbed(card)) recordErase(card.getId());
+    }
+    cards.erase(std::remove_if(cards.begin(), cards.end(), absorbed), cards.end());
+    cardIndexDirty = true;
+    cardGridDirty = true;
+    lastClickedCard = nullptr;
+    
+    Card* pile = findCardById(stackId);
+    if (!pile) return;
+    pile->setCount(total);
+    bringCardToFront(pile);
+    pile = &cards.back();
+    recordCard(*pile, pile->getBasePosition(), JOURNAL_TO_FRONT);
+    DEBUG_CARD("Pile %u now holds %u cards of type %d\n", stackId, total, (int)pile->getType());
+}
+
+Card& Game::splitPile(Card* pile) {
+    // One card comes off the top where the pile is; the pile keeps its id and place
+    CardType type = pile->getType();
+    Vector2 pos = pile->getPosition();
+    pile->setCount(pile->getCount() - 1);
+    recordCard(*pile, pile->getBasePosition(), 0);
+    return spawnCard(type, pos); // Appends, which invalidates `pile`
 }
 
 void Game::updateHandCardDrag(Vector2 mousePos) {
     if (draggingHandCard && isDraggingFromHand) {
-        // Calculate new position: mouse position minus the drag offset
+        // Calculate new position: mouse position minus the drag offset (hand cards are in screen space)
         Vector2 newPos = Vector2(mousePos.x - dragOffset.x, mousePos.y - dragOffset.y);
         draggingHandCard->setPosition(newPos);
 
         // While dragging from hand, check for stack snap targets as well
-        if (designManager.getEnableCardStacking()) {
-            // Create a temporary card at the hand card position to test overlaps
-            Card temp(draggingHandCard->getType(), draggingHandCard->getPosition());
+        if (design->enableCardStacking) {
+            // Create a temporary card where the hand card is over the playmat to test overlaps
+            Card temp(draggingHandCard->getType(), camera.screenToWorld(newPos));
             int targetIdx = findOverlapTargetIndex(&temp, stackOverlapThreshold);
             if (targetIdx != -1) {
                 Vector2 targetBase = cards[targetIdx].getBasePosition();
                 int currentStack = getStackCountAtBasePosition(targetBase);
-                if (currentStack < designManager.getMaxStackSize()) {
+                DropAction action = classifyDrop(targetIdx, temp);
+                if (action != DropAction::NONE) {
                     isOverStackTarget = true;
                     stackTargetIndex = targetIdx;
-                    Vector2 snapPos = Vector2(targetBase.x + (currentStack * stackVisualOffsetX), targetBase.y + (currentStack * stackVisualOffsetY));
-                    draggingHandCard->setPosition(snapPos);
+                    int snapIndex = (action == DropAction::MERGE) ? 0 : currentStack;
+                    SDL_FRect snapRect = camera.worldToScreen({targetBase.x + (snapIndex * stackVisualOffsetX),
+                                                               targetBase.y + (snapIndex * stackVisualOffsetY), 0, 0});
+                    draggingHandCard->setPosition(Vector2(snapRect.x, snapRect.y));
                 } else {
                     isOverStackTarget = false;
                     stackTargetIndex = -1;
@@ -694,3 +2144,296 @@ void Game::updateHandCardDrag(Vector2 mousePos) {
         }
     }
 }
+
+void Game::startRecording() {
+    // Snap the board to its saved form (e.g. tweens finished) so replay starts from an identical state
+    SaveData start;
+    captureSave(start);
+    restoreSave(start);
+    inputStartTick = craftTimers.getCurrentTick();
+    recorder.start(options.recordPath, contentHash, randomSeed, start);
+}
+
+bool Game::startReplay() {
+    if (!replay.load(options.replayPath)) return false;
+    if (replay.contentHash != contentHash) {
+        printf("[REPLAY] Warning: %s was recorded with different config files; it may play out differently\n",
+               options.replayPath.c_str());
+    }
+    restoreSave(replay.startBoard);
+    randomSeed = replay.seed;
+    random.seed(randomSeed);
+    inputStartTick = craftTimers.getCurrentTick();
+    replaying = true;
+    printf("[REPLAY] Playing %zu events over %llu ticks from %s\n", replay.getEventCount(),
+           (unsigned long long)replay.getTickCount(), options.replayPath.c_str());
+    return true;
+}
+
+void Game::feedReplay() {
+    if (!replaying) return;
+    // Events recorded before tick N were handled before update() ran tick N
+    Uint64 tick = craftTimers.getCurrentTick() - inputStartTick;
+    SDL_Event e;
+    while (replay.next(tick, e)) {
+        handleEvent(e);
+    }
+    if (replay.isFinished(tick)) {
+        replaying = false;
+        printf("[REPLAY] Finished after %llu ticks; %zu cards on the playmat\n", (unsigned long long)tick, cards.size());
+        if (options.headless) running = false;
+    }
+}
+
+void Game::runHeadless() {
+    // Fixed ticks back to back, with no rendering or frame pacing
+    Uint64 startTime = SDL_GetTicksNS();
+    Uint64 startTick = craftTimers.getCurrentTick();
+    while (running) {
+        runBot();
+        runAllocTest();
+        feedReplay();
+        if (!running) break;
+        if (options.replayPath.empty() && !options.bot && !options.allocTest && craftTimers.getCurrentTick() - startTick >= options.headlessTicks) break;
+        update();
+        endFrameStats(); // Each tick counts as a frame for --profile and the bot
+    }
+    Uint64 ticks = craftTimers.getCurrentTick() - startTick;
+    double seconds = (SDL_GetTicksNS() - startTime) / 1e9;
+    printf("[HEADLESS] Simulated %llu ticks in %.3f s (%.0f ticks/s, %.1fx real time)\n", (unsigned long long)ticks, seconds,
+           seconds > 0.0 ? ticks / seconds : 0.0, seconds > 0.0 ? ticks / (seconds * SIM_TICK_RATE) : 0.0);
+}
+
+static void hashCard(StateHasher& hasher, const Card& card) {
+    hasher.add(card.getId());
+    hasher.add(card.getStackId());
+    hasher.add((Uint32)card.getType());
+    hasher.add(card.getCount());
+    hasher.add((Uint32)card.getState());
+    hasher.add(card.getPosition().x);
+    hasher.add(card.getPosition().y);
+    hasher.add(card.getBasePosition().x);
+    hasher.add(card.getBasePosition().y);
+    hasher.add(card.getAnimationOffset());
+}
+
+Uint64 Game::hashSimulationState(Uint64 tick) {
+    // Folds this tick's state into the previous hash, so a divergence shows on every later tick too
+    StateHasher hasher(stateHash);
+    hasher.add(tick);
+    hasher.add(nextCardId);
+    hasher.addBytes(random.getState(), 4 * sizeof(Uint64));
+    hasher.add(draggingCard ? draggingCard->getId() : 0u);
+    hasher.add(isDraggingFromHand);
+    for (const auto& card : cards) {
+        hashCard(hasher, card);
+    }
+    for (const auto& card : handCards) {
+        hashCard(hasher, card);
+    }
+    
+    // activeCrafts is unordered; hash it by stack id
+    hashCraftIds.clear();
+    for (const auto& entry : activeCrafts) {
+        hashCraftIds.push_back(entry.first);
+    }
+    std::sort(hashCraftIds.begin(), hashCraftIds.end());
+    for (Uint32 stackId : hashCraftIds) {
+        const ActiveCraft& craft = activeCrafts[stackId];
+        hasher.add(stackId);
+        hasher.add(craft.recipeIndex);
+        hasher.add(craft.startTick - inputStartTick);
+        hasher.add(craft.durationTicks);
+    }
+    return hasher.get();
+}
+
+bool Game::startScenario() {
+    ScenarioSpec spec;
+    if (!loadScenario(options.scenarioPath, spec)) return false;
+    if (options.scenarioCards > 0) {
+        spec.cardCount = options.scenarioCards;
+    }
+    
+    Uint64 startTime = SDL_GetTicksNS();
+    ScenarioLayout layout;
+    layout.cardSize = Card(CardType::VILLAGER, Vector2(0, 0)).getSize();
+    layout.stackOffset = Vector2(stackVisualOffsetX, stackVisualOffsetY);
+    layout.maxStackSize = design->maxStackSize;
+    SaveData data;
+    generateScenario(spec, recipes, layout, data);
+    for (const auto& card : handCards) {
+        data.handCards.push_back(makeCardRecord(card));
+    }
+    data.tick = craftTimers.getCurrentTick();
+    restoreSave(data);
+    printf("[SCENARIO] Generated '%s': %zu cards in %zu stacks, %zu crafting, in %.2f ms\n", spec.name.c_str(),
+           cards.size(), data.stacks.size(), activeCrafts.size(), (SDL_GetTicksNS() - startTime) / 1000000.0);
+    return true;
+}
+
+BotSettings Game::getBotSettings() const {
+    BotSettings settings;
+    settings.actionsPerMinute = design->botActionsPerMinute;
+    settings.craftChance = design->botCraftChance;
+    settings.handChance = design->botHandChance;
+    settings.undoChance = design->botUndoChance;
+    settings.reportSeconds = std::max(design->botReportSeconds, 1.0f);
+    return settings;
+}
+
+void Game::runBot() {
+    if (!options.bot || replaying) return;
+    Uint64 elapsed = craftTimers.getCurrentTick() - botStartTick;
+    if (options.botMinutes > 0 && elapsed >= (Uint64)options.botMinutes * 60 * SIM_TICK_RATE) {
+        printf("[BOT] Ran for %u simulated minutes\n", options.botMinutes);
+        running = false;
+        return;
+    }
+    
+    // Drops land above the hand, inside the default window
+    BotView view;
+    view.cards = &cards;
+    view.handCards = &handCards;
+    view.recipes = &recipes;
+    view.playArea = {0.0f, 0.0f, (float)design->windowWidth - 100.0f, handArea.y - 250.0f};
+    view.handEnabled = design->showHand;
+    botEvents.clear();
+    bot.update(view, botEvents);
+    for (const SDL_Event& e : botEvents) {
+        dispatchEvent(e);
+    }
+}
+
+void Game::endFrameStats() {
+    // Called at a frame boundary, when the simulation isn't running
+    bool reported = Profiler::get().endFrame();
+    if (cards.size() > peakCardCount) peakCardCount = cards.size();
+    if (options.bot && bot.endFrame()) {
+        bot.report(cards.size(), validateBoard());
+        reported = true;
+    }
+    if (reported) {
+        printPoolStats();
+    }
+    if (options.allocTest) {
+        checkFrameAllocations();
+    }
+}
+
+void Game::printPoolStats() {
+    // Cards are stored by value in one contiguous vector; its spare capacity is their pool
+    std::vector<PoolStats> pools;
+    pools.push_back({"cards", sizeof(Card), cards.capacity(), cards.size(), peakCardCount, (Uint64)(nextCardId - 1)});
+    pools.push_back(craftTimers.getPoolStats());
+    FixedBlockPool::collectStats(pools);
+    for (const PoolStats& pool : pools) {
+        double occupancy = pool.capacity > 0 ? 100.0 * pool.live / pool.capacity : 0.0;
+        printf("[POOL]   %-14s %5zu B  %8zu / %8zu live (%5.1f%%)  peak %8zu  %10llu allocations\n", pool.name,
+               pool.blockSize, pool.live, pool.capacity, occupancy, pool.peak, (unsigned long long)pool.allocations);
+    }
+}
+
+int Game::validateBoard() {
+    // Invariants a long session must keep; violations point at stack or pointer corruption
+    int problems = 0;
+    auto problem = [&problems](const char* message, Uint32 id) {
+        if (problems++ < 5) printf("[BOT] Board problem: %s (id %u)\n", message, id);
+    };
+    
+    std::unordered_map<Uint32, const Card*> byId;
+    byId.reserve(cards.size());
+    for (const auto& card : cards) {
+        if (card.getId() == 0 || !byId.emplace(card.getId(), &card).second) problem("card id is zero or repeated", card.getId());
+    }
+    for (const auto& card : cards) {
+        auto root = byId.find(card.getStackId());
+        if (root == byId.end() || root->second->getStackId() != root->first) {
+            problem("card's stack has no root card", card.getId());
+            continue;
+        }
+        if (card.isPile() && card.getStackId() != card.getId()) problem("pile inside another stack", card.getId());
+        if (root->second->isPile() && root->second != &card) problem("card stacked on a pile", card.getId());
+        Vector2 base = card.getBasePosition();
+        Vector2 rootBase = root->second->getBasePosition();
+        if (fabs(base.x - rootBase.x) > 0.1f || fabs(base.y - rootBase.y) > 0.1f) problem("stack member off the stack's base", card.getId());
+    }
+    for (const auto& entry : activeCrafts) {
+        if (byId.find(entry.first) == byId.end()) problem("craft on a stack that no longer exists", entry.first);
+    }
+    if (!cardIndexDirty) {
+        for (Uint32 id = 0; id < cardIndexById.size(); id++) {
+            int index = cardIndexById[id];
+            if (index == -1) continue;
+            if (index < 0 || index >= (int)cards.size() || cards[index].getId() != id) {
+                problem("stale card index entry", id);
+            }
+        }
+    }
+    
+    const Card* cardsBegin = cards.data();
+    const Card* cardsEnd = cardsBegin + cards.size();
+    if (draggingCard && (draggingCard < cardsBegin || draggingCard >= cardsEnd)) problem("dragged card pointer is dangling", 0);
+    if (isDragging && !draggingCard) problem("dragging without a dragged card", 0);
+    const Card* handBegin = handCards.data();
+    const Card* handEnd = handBegin + handCards.size();
+    if (draggingHandCard && (draggingHandCard < handBegin || draggingHandCard >= handEnd)) problem("dragged hand card pointer is dangling", 0);
+    if (hoveredHandCard && (hoveredHandCard < handBegin || hoveredHandCard >= handEnd)) problem("hovered hand card pointer is dangling", 0);
+    if (stackTargetIndex < -1 || stackTargetIndex >= (int)cards.size()) problem("stack target index out of range", (Uint32)stackTargetIndex);
+    return problems;
+}
+
+void Game::runAllocTest() {
+    if (!options.allocTest || !running) return;
+    Uint64 t = craftTimers.getCurrentTick() - allocTestStartTick;
+    if (t < ALLOC_TEST_GRAB_TICK || t > ALLOC_TEST_RELEASE_TICK) return;
+    
+    // A circle that starts and ends at the grab point
+    float angle = 2.0f * SDL_PI_F * (float)(t - ALLOC_TEST_GRAB_TICK) / (float)ALLOC_TEST_LAP_TICKS;
+    Vector2 pos = Vector2(allocTestGrab.x + ALLOC_TEST_RADIUS * sinf(angle),
+                          allocTestGrab.y + ALLOC_TEST_RADIUS * (1.0f - cosf(angle)));
+    Uint32 type = SDL_EVENT_MOUSE_MOTION;
+    if (t == ALLOC_TEST_GRAB_TICK) {
+        type = SDL_EVENT_MOUSE_BUTTON_DOWN;
+    } else if (t == ALLOC_TEST_RELEASE_TICK) {
+        type = SDL_EVENT_MOUSE_BUTTON_UP;
+        pos = allocTestGrab;
+    }
+    dispatchEvent(makeMouseEvent(type, pos));
+}
+
+void Game::checkFrameAllocations() {
+    // Called from endFrameStats; a frame is measured when every tick it simulated lies in a measured stretch
+    Uint64 t = craftTimers.getCurrentTick() - allocTestStartTick;
+    Uint64 from = allocTestLastTick;
+    allocTestLastTick = t;
+    
+    const char* phase = nullptr;
+    if (from >= ALLOC_TEST_GRAB_TICK + ALLOC_TEST_LAP_TICKS && t <= ALLOC_TEST_RELEASE_TICK) {
+        phase = "drag";
+    } else if (from >= ALLOC_TEST_IDLE_TICK && t <= ALLOC_TEST_END_TICK) {
+        phase = "idle";
+    }
+    if (phase) {
+        allocTestFrames++;
+        Profiler& profiler = Profiler::get();
+        if (profiler.getLastFrameAllocations() > 0) {
+            if (allocTestFailures++ < 10) {
+                printf("[ALLOC] %s frame at tick %llu made %llu allocations (%llu bytes)\n", phase, (unsigned long long)t,
+                       (unsigned long long)profiler.getLastFrameAllocations(), (unsigned long long)profiler.getLastFrameBytes());
+                profiler.printLastFrameAllocations();
+            }
+        }
+    }
+    
+    if (t >= ALLOC_TEST_END_TICK) {
+        if (allocTestFailures > 0) {
+            printf("[ALLOC] FAILED: %llu of %llu measured frames allocated\n", (unsigned long long)allocTestFailures,
+                   (unsigned long long)allocTestFrames);
+            exitCode = 1;
+        } else {
+            printf("[ALLOC] Passed: %llu measured frames without an allocation\n", (unsigned long long)allocTestFrames);
+        }
+        running = false;
+    }
+}
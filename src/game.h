@@ -5,28 +5,167 @@
 #include "board.h"
 #include "color_manager.h"
 #include "design_manager.h"
+#include "timer_wheel.h"
+#include "tween_system.h"
+#include "job_system.h"
+#include "frame_snapshot.h"
+#include "frame_arena.h"
+#include "pool_allocator.h"
+#include "config_watcher.h"
+#include "save_game.h"
+#include "autosave.h"
+#include "journal.h"
+#include "undo_history.h"
+#include "input_recording.h"
+#include "sim_random.h"
+#include "state_hash.h"
+#include "scenario.h"
+#include "bot_player.h"
+#include "stack_impostor.h"
+#include "camera.h"
+#include "spatial_grid.h"
 #include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Startup options parsed from the command line in main.cpp
+struct GameOptions {
+    bool pipelined;        // --pipelined: simulate frame N+1 on a worker thread while rendering frame N
+    std::string loadPath;  // --load <file>: start from a saved board instead of the default layout
+    bool profile;          // --profile: print profiler scope timings every few seconds
+    std::string recordPath; // --record <file>: record input for later replay
+    std::string replayPath; // --replay <file>: play back a recording instead of live input
+    bool headless;         // --headless: with --replay or --scenario, no window; simulate as fast as possible
+    std::string scenarioPath;    // --scenario <file>: start from a generated board instead of the default layout
+    Uint32 scenarioCards;  // --cards <n>: override the scenario's card count
+    Uint32 headlessTicks;  // --ticks <n>: how long --headless runs a scenario
+    bool deterministic;    // --deterministic: input is applied only at tick boundaries
+    Uint64 seed;           // --seed <n>: SimRandom seed; 0 picks one from the clock
+    std::string hashLogPath;     // --hash-log <file>: write a rolling state hash per tick (implies --deterministic)
+    std::string hashComparePath; // --hash-compare <file>: report the first tick that differs from this log
+    bool bot;              // --bot: a built-in player drives the input (soak / load testing)
+    Uint32 botMinutes;     // --bot-minutes <n>: quit after n simulated minutes; 0 runs until closed
+    bool allocTest;        // --alloc-test: idle and drag a card, failing on any frame that allocates after warm-up
+
+    GameOptions() : pipelined(false), profile(false), headless(false), scenarioCards(0), headlessTicks(600),
+                    deterministic(false), seed(0), bot(false), botMinutes(0), allocTest(false) {}
+};
+
+// A recipe craft in progress on one stack, keyed by stack id in Game::activeCrafts
+struct ActiveCraft {
+    TimerHandle timer;
+    int recipeIndex;
+    Uint64 startTick;
+    Uint64 durationTicks;
+    SDL_FRect barRect;     // Progress bar drawn above the stack
+};
+
+// Pool for the per-stack craft entries in Game::activeCrafts
+struct CraftPool {
+    static constexpr const char* name = "stack crafts";
+};
+using CraftMap = std::unordered_map<Uint32, ActiveCraft, std::hash<Uint32>, std::equal_to<Uint32>,
+                                    PoolAllocator<std::pair<const Uint32, ActiveCraft>, CraftPool>>;
+
+// Per-frame draw counts for the stats overlay (render thread)
+struct RenderStats {
+    size_t cards;          // Playmat cards in the snapshot
+    size_t edges;          // Covered stack members drawn as an edge strip
+    size_t occluded;       // Skipped: hidden behind cards higher in z-order
+    size_t impostors;      // Stacks drawn as one cached texture
+    size_t impostorBuilds; // ... of which were (re)rendered this frame
+    size_t impostorCards;  // Cards covered by those textures
+};
+
+// What dropping a card onto a stack does (see Game::classifyDrop)
+enum class DropAction {
+    NONE,                  // Not allowed; the card stays loose where it was dropped
+    STACK,                 // The card goes on top of the stack
+    MERGE                  // The stack and the card collapse into one pile
+};
+
+// A dirty stack gathered for recipe evaluation (frame arena data, rebuilt every tick)
+struct CraftCandidate {
+    Uint32 stackId;
+    Uint32 firstType;      // Offset of the stack's card types in the flattened type array
+    Uint32 typeCount;
+    bool busy;             // A member is being dragged or is a pile (piles never craft)
+    Vector2 base;
+    float cardWidth;
+    int recipeIndex;       // Matched recipe, or -1; written by the evaluation jobs
+};
 
 class Game {
 private:
     SDL_Window* window;
     SDL_Renderer* renderer;
-    bool running;
+    std::atomic<bool> running;
+    GameOptions options;
+    JobSystem jobs;         // Worker threads for the parallel simulation phases
     
     std::vector<Card> cards;        // Cards on the playmat
     std::vector<Card> handCards;    // Cards in player's hand
     std::vector<Recipe> recipes;
+    Uint32 nextCardId;
     Board board;
     ColorManager colorManager;
     DesignManager designManager;
+    const DesignSettings* design;   // Resolved settings read by hot paths
+    ConfigWatcher configWatcher;    // Hot-reloads colors.conf and design.json
+    AutosaveWorker autosave;        // Writes autosaves off the main thread
+    Uint64 lastAutosaveTick;
+    Journal journal;                // Mutations since the last journal snapshot, for crash recovery
+    AutosaveWorker journalSnapshots;  // Writes the journal's base snapshots, apart from the player's autosave
+    Uint64 lastJournalSnapshotTick;
+    bool journalSnapshotDue;        // The board was replaced wholesale; fold the journal into a snapshot without waiting
+    UndoHistory undoHistory;        // Board snapshots taken before each drag (Ctrl+Z / Ctrl+Y)
+    Uint64 contentHash;             // Hash of the config sources, stamped into input recordings
+    InputRecorder recorder;
+    InputReplay replay;
+    bool replaying;                 // Input comes from `replay` until it finishes
+    Uint64 inputStartTick;          // Tick the recording or replay started on
+    
+    // Determinism mode
+    SimRandom random;               // The only source of gameplay randomness
+    Uint64 randomSeed;
+    std::vector<SDL_Event> tickEvents;   // Input waiting for the next tick
+    TickHashLog hashLog;
+    Uint64 stateHash;               // Rolling hash of the board, folded in once per tick
+    std::vector<Uint32> hashCraftIds;    // Scratch: active craft stack ids in a stable order
+    
+    // Bot player
+    BotPlayer bot;
+    std::vector<SDL_Event> botEvents;    // Scratch: the bot's input for this tick
+    Uint64 botStartTick;
+    size_t peakCardCount;           // Most playmat cards seen at a frame boundary, for the pool report
+    
+    // Zero-allocation test (--alloc-test)
+    Uint64 allocTestStartTick;
+    Vector2 allocTestGrab;          // Where the test picked up its card; the drag circles around it
+    Uint64 allocTestLastTick;       // Test tick at the end of the previous frame
+    Uint64 allocTestFrames;         // Frames measured so far
+    Uint64 allocTestFailures;       // Measured frames that allocated
+    int exitCode;
     
     // Click and animation state
-    Card* animatingCard;
-    float animationTimer;
-    float animationDuration;
+    TweenSystem tweens;     // All active card animations (lift, position)
+    float pickupDuration;   // Seconds for the pickup bounce
+    float liftDuration;     // Seconds for drag lift / drop / hover transitions
+    float relayoutDuration; // Seconds for cards sliding into stack position
     Vector2 lastClickPos;  // For debugging
+    Vector2 lastMousePos;  // Last mouse position seen in an event
     Card* lastClickedCard; // For debugging
     
+    // Camera: the playmat is drawn and hit-tested in world space, the hand in screen space
+    Camera camera;
+    bool isPanning;        // Middle mouse button held
+    bool outputResized;    // The window's pixel size changed; the camera picks it up at the frame boundary
+    SpatialGrid cardGrid;  // Card indices by area, for the viewport query
+    std::vector<Uint32> visibleCards;    // Scratch: indices of the cards on screen, in z-order
+    
     // Drag state
     Card* draggingCard;
     Vector2 dragOffset;    // Offset from card position to mouse when drag started
@@ -47,35 +186,160 @@ private:
     // Hand state
     Card* hoveredHandCard;  // Card currently being hovered in hand
     float handCardScale;    // Scale factor for hovered card
+    float handHoverLift;    // How far a hovered hand card rises (half the card height)
     Vector2 handArea;       // Position and size of hand area
     float handCardSpacing;  // Spacing between cards in hand
     
+    // Timed crafting state
+    TimerWheel craftTimers;                              // Fires completed crafts, one tick per update()
+    CraftMap activeCrafts;                               // Stack id -> craft in progress
+    std::vector<Uint32> dirtyStacks;                     // Stacks whose membership changed this tick
+    std::vector<Uint32> expiredCrafts;                   // Scratch buffer for craftTimers.advance
+    std::unordered_map<Uint32, Uint32> saveStackIndex;   // Stack id -> record, scratch for captureSave
+    
+    // Card id -> index into cards (-1 when not on the playmat), rebuilt lazily after the vector is
+    // reordered. Ids are dense, so a flat table rebuilds in place without allocating.
+    std::vector<int> cardIndexById;
+    bool cardIndexDirty;
+    bool cardGridDirty;             // cardGrid is stale: a playmat card other than the dragged one moved, or the vector was reordered
+    
+    // Scratch memory for one update() (simulation thread) and one renderSnapshot() (render thread)
+    FrameArena simArena;
+    FrameArena renderArena;
+    
+    // Fixed-tick timing
+    Uint64 lastTickTime;
+    Uint64 tickAccumulator;
+    
+    // Render snapshots: in pipelined mode the simulation fills one while the other is drawn
+    FrameSnapshot frames[2];
+    int frontFrame;
+    std::vector<int> snapshotStackSlot;  // Stack id -> index into the snapshot's stacks, -1 between captures
+    
+    // Stack id -> version, bumped on every membership change so cached stack textures go stale;
+    // 0 means "unchanged since the board was last replaced", which reads as stackVersionBase
+    std::vector<Uint32> stackVersions;
+    Uint32 stackVersionCounter;
+    Uint32 stackVersionBase;
+    StackImpostorCache impostors;        // Render thread only
+    
+    // Pipelined mode: main thread pumps SDL events and renders, simulation runs on simThread
+    std::thread simThread;
+    std::mutex pipelineMutex;
+    std::condition_variable pipelineCondition;
+    bool simRequested;
+    bool simFinished;
+    bool simQuit;
+    std::vector<SDL_Event> pendingEvents;   // Collected by the main thread during the current frame
+    std::vector<SDL_Event> simEvents;       // Handed to the simulation for the next frame
+    
 public:
     Game();
     ~Game();
     
-    bool init();
+    bool init(const GameOptions& gameOptions = GameOptions());
     void run();
     void cleanup();
+    // Non-zero when a test mode failed
+    int getExitCode() const { return exitCode; }
     
 private:
     void handleEvents();
+    void dispatchEvent(const SDL_Event& e);
+    void handleEvent(const SDL_Event& e);
+    void runSimulationTicks();
+    void applyConfigReloads();
+    void updateAutosave();
+    void updateJournalSnapshot();
+    void saveOnExit();
     void update();
     void render();
     
+    // Snapshot rendering
+    void captureSnapshot(FrameSnapshot& snapshot);
+    void renderSnapshot(const FrameSnapshot& snapshot);
+    
+    // Input recording and replay
+    void startRecording();
+    bool startReplay();
+    void feedReplay();
+    void runHeadless();
+    bool startScenario();
+    
+    // Bot player and soak-test checks
+    BotSettings getBotSettings() const;
+    void runBot();
+    void endFrameStats();
+    void printPoolStats();
+    int validateBoard();
+    void runAllocTest();
+    void checkFrameAllocations();
+    Uint64 hashSimulationState(Uint64 tick);
+    
+    // Pipelined mode
+    void runPipelined();
+    void simulationLoop();
+    void kickSimulation();
+    void waitForSimulation();
+    
     void initializeCards();
     void initializeHand();
-    void initializeRecipes();
+    void loadContent();
+    void loadRecipes(const char* path);
     void processRecipes();
     
+    // Save / load (F5 / F9 use the quicksave slot)
+    bool saveGame(const std::string& path);
+    bool loadGame(const std::string& path);
+    void captureSave(SaveData& data);
+    void restoreSave(const SaveData& data);
+    void fitBoardToCards();
+    
+    // Crash-recovery journal and undo history; the record* helpers report each board mutation to both
+    void startJournal();
+    void resetUndoHistory();
+    void stepUndoHistory(bool forward);
+    void recordCard(const Card& card, Vector2 position, Uint16 flags);
+    void recordErase(Uint32 cardId);
+    void recordCraftStart(Uint32 stackId, const ActiveCraft& craft);
+    void recordCraftEnd(Uint32 stackId);
+    
+    // Timed crafting methods
+    Card& spawnCard(CardType type, Vector2 pos);
+    int findCardIndexById(Uint32 id);
+    Card* findCardById(Uint32 id);
+    int findRecipeIndex(const CardType* sortedTypes, size_t count) const;
+    void markStackDirty(Uint32 stackId);
+    void bumpStackVersion(Uint32 stackId);
+    void detachFromStack(Card* card);
+    void cancelCraft(Uint32 stackId);
+    void completeCraft(Uint32 stackId);
+    void renderCraftProgress(SDL_Renderer* renderer, const FrameSnapshot& snapshot);
+    void renderCountBadge(SDL_Renderer* renderer, SDL_FRect rect, Uint32 count);
+    void analyzeStacks(FrameSnapshot& snapshot);
+    bool drawImpostor(const FrameSnapshot& snapshot, const StackSnapshot& stack, RenderStats& stats);
+    void handleRenderReset(const SDL_Event& e);
+    void handleResize(const SDL_Event& e);
+    void applyResize();
+    void updateViewSize();
+    Uint32 getStackVersion(Uint32 stackId) const;
+    size_t cullOccludedCards(const FrameSnapshot& snapshot, const SDL_FRect* rects, bool* culled);
+    void renderStatsOverlay(SDL_Renderer* renderer, const RenderStats& stats);
+    
     // Click and animation methods
     Card* getCardAt(Vector2 pos);
     Card* getHandCardAt(Vector2 pos);
     void bringCardToFront(Card* card);
     void startPickupAnimation(Card* card);
-    void renderDebugInfo(SDL_Renderer* renderer);
+    void markCardMoved(const Card* card);
+    void animateLift(Card* card, float to);
+    void animateHover(Card* card, float to);
+    void animateMove(Card* card, Vector2 to);
+    void updateTweens();
+    void renderDebugInfo(SDL_Renderer* renderer, const FrameSnapshot& snapshot);
     
     // Drag methods
+    void pickUpCard(Card* card, Vector2 mousePos, bool wholePile);
     void startDrag(Card* card, Vector2 mousePos);
     void updateDrag(Vector2 mousePos);
     void stopDrag();
@@ -84,17 +348,24 @@ private:
     void startHandCardDrag(Card* handCard, Vector2 mousePos);
     void updateHandCardDrag(Vector2 mousePos);
     void stopHandCardDrag();
+    void followCamera();
     bool isOverPlaymat(Vector2 mousePos); // Helper to check if position is over playmat
     
     // Hand methods
     void updateHandHover(Vector2 mousePos);
-    void renderHand(SDL_Renderer* renderer);
+    void renderHand(SDL_Renderer* renderer, const FrameSnapshot& snapshot);
     void playCardFromHand(Card* handCard, Vector2 position);
 
     // Stacking helpers
+    bool isStackMemberAt(const Card& card, const Vector2& basePos) const;
     int getStackCountAtBasePosition(const Vector2& basePos) const;
     int findOverlapTargetIndex(const Card* sourceCard, float requiredFraction) const;
-    void finalizeStacking(int targetIndex, int sourceIndex);
+    bool finalizeStacking(int targetIndex, int sourceIndex); // False when the drop was refused
+    
+    // Piles: one entity standing for many identical cards
+    DropAction classifyDrop(int targetIndex, const Card& source) const;
+    void mergeIntoPile(int targetIndex, int sourceIndex);
+    Card& splitPile(Card* pile);
     
     // Color management
     const ColorManager& getColorManager() const { return colorManager; }
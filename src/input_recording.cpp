@@ -0,0 +1,192 @@
+#include "input_recording.h"
+#include "config_parser.h"
+#include <cstring>
+
+// Bump whenever InputRecordingHeader or InputEventRecord changes
+static const Uint32 RECORDING_VERSION = 3;
+static const char RECORDING_MAGIC[4] = {'S', 'L', 'I', 'R'};
+
+struct InputRecordingHeader {
+    char magic[4];
+    Uint32 version;
+    Uint64 contentHash;    // ContentCache::hashSources of the config files when recorded
+    Uint64 seed;           // SimRandom seed the session started with
+    Uint64 tickCount;      // Length of the recording; 0 if the game never stopped it
+    Uint32 saveSize;       // Bytes of start board following the header
+    Uint32 eventCount;     // Events following the start board; 0 if the game never stopped it
+};
+
+static_assert(sizeof(InputRecordingHeader) == 40 && sizeof(InputEventRecord) == 24,
+              "Input recording layout changed; bump RECORDING_VERSION");
+
+InputRecorder::InputRecorder() : file(nullptr), contentHash(0), seed(0), saveSize(0), eventCount(0) {}
+
+InputRecorder::~InputRecorder() {
+    stop(0);
+}
+
+bool InputRecorder::start(const std::string& recordingPath, Uint64 sourceHash, Uint64 randomSeed, const SaveData& startBoard) {
+    std::string board;
+    if (!encodeSave(startBoard, board)) return false;
+
+    file = fopen(recordingPath.c_str(), "wb");
+    if (!file) {
+        printf("[RECORD] Could not open %s for writing\n", recordingPath.c_str());
+        return false;
+    }
+    path = recordingPath;
+    contentHash = sourceHash;
+    seed = randomSeed;
+    saveSize = (Uint32)board.size();
+    eventCount = 0;
+    if (!writeHeader(0) || fwrite(board.data(), 1, board.size(), file) != board.size()) {
+        printf("[RECORD] Could not write %s\n", path.c_str());
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+    printf("[RECORD] Recording input to %s\n", path.c_str());
+    return true;
+}
+
+bool InputRecorder::writeHeader(Uint64 tickCount) {
+    InputRecordingHeader header = {};
+    memcpy(header.magic, RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+    header.version = RECORDING_VERSION;
+    header.contentHash = contentHash;
+    header.seed = seed;
+    header.tickCount = tickCount;
+    header.saveSize = saveSize;
+    header.eventCount = eventCount;
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+void InputRecorder::record(const SDL_Event& e, Uint64 tick) {
+    if (!file) return;
+
+    InputEventRecord record = {};
+    record.tick = (Uint32)tick;
+    record.type = e.type;
+    switch (e.type) {
+        case SDL_EVENT_QUIT:
+            break;
+        case SDL_EVENT_KEY_DOWN:
+            record.code = (Uint16)e.key.scancode;
+            record.mod = (Uint16)e.key.mod;
+            break;
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            record.code = e.button.button;
+            record.x = e.button.x;
+            record.y = e.button.y;
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+            record.x = e.motion.x;
+            record.y = e.motion.y;
+            break;
+        case SDL_EVENT_MOUSE_WHEEL:
+            record.x = e.wheel.mouse_x;
+            record.y = e.wheel.mouse_y;
+            record.scroll = e.wheel.y;
+            break;
+        default:
+            return;
+    }
+    // Buffered by stdio; a recording is read only after the session ends
+    if (fwrite(&record, sizeof(record), 1, file) == 1) {
+        eventCount++;
+    }
+}
+
+void InputRecorder::stop(Uint64 tickCount) {
+    if (!file) return;
+    bool written = fseek(file, 0, SEEK_SET) == 0 && writeHeader(tickCount);
+    written = (fclose(file) == 0) && written;
+    file = nullptr;
+    if (written) {
+        printf("[RECORD] Wrote %u events over %llu ticks to %s\n", eventCount, (unsigned long long)tickCount, path.c_str());
+    } else {
+        printf("[RECORD] Could not finish %s\n", path.c_str());
+    }
+}
+
+InputReplay::InputReplay() : nextEvent(0), tickCount(0), contentHash(0), seed(0) {}
+
+bool InputReplay::load(const std::string& path) {
+    events.clear();
+    nextEvent = 0;
+    tickCount = 0;
+
+    std::string blob;
+    if (!readConfigFile(path, blob)) {
+        printf("[REPLAY] Could not open %s\n", path.c_str());
+        return false;
+    }
+    InputRecordingHeader header;
+    if (blob.size() < sizeof(header)) {
+        printf("[REPLAY] %s is not an input recording\n", path.c_str());
+        return false;
+    }
+    memcpy(&header, blob.data(), sizeof(header));
+    if (memcmp(header.magic, RECORDING_MAGIC, sizeof(RECORDING_MAGIC)) != 0) {
+        printf("[REPLAY] %s is not an input recording\n", path.c_str());
+        return false;
+    }
+    if (header.version != RECORDING_VERSION) {
+        printf("[REPLAY] %s has version %u, expected %u\n", path.c_str(), header.version, RECORDING_VERSION);
+        return false;
+    }
+    if (blob.size() < sizeof(header) + (Uint64)header.saveSize ||
+        !decodeSave(blob.data() + sizeof(header), header.saveSize, path, startBoard)) {
+        printf("[REPLAY] %s has no valid start board\n", path.c_str());
+        return false;
+    }
+
+    // A session that never stopped recording leaves the counts at 0; keep every whole record
+    size_t eventBytes = blob.size() - sizeof(header) - header.saveSize;
+    size_t count = eventBytes / sizeof(InputEventRecord);
+    if (header.eventCount != 0 && header.eventCount < count) count = header.eventCount;
+    events.resize(count);
+    if (count > 0) {
+        memcpy(events.data(), blob.data() + sizeof(header) + header.saveSize, count * sizeof(InputEventRecord));
+    }
+    contentHash = header.contentHash;
+    seed = header.seed;
+    tickCount = header.tickCount;
+    if (tickCount == 0 && !events.empty()) tickCount = events.back().tick;
+    return true;
+}
+
+bool InputReplay::next(Uint64 tick, SDL_Event& e) {
+    if (nextEvent == events.size() || events[nextEvent].tick > tick) return false;
+    const InputEventRecord& record = events[nextEvent++];
+
+    memset(&e, 0, sizeof(e));
+    e.type = record.type;
+    switch (record.type) {
+        case SDL_EVENT_KEY_DOWN:
+            e.key.scancode = (SDL_Scancode)record.code;
+            e.key.mod = record.mod;
+            e.key.down = true;
+            break;
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            e.button.button = (Uint8)record.code;
+            e.button.down = (record.type == SDL_EVENT_MOUSE_BUTTON_DOWN);
+            e.button.x = record.x;
+            e.button.y = record.y;
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+            e.motion.x = record.x;
+            e.motion.y = record.y;
+            break;
+        case SDL_EVENT_MOUSE_WHEEL:
+            e.wheel.mouse_x = record.x;
+            e.wheel.mouse_y = record.y;
+            e.wheel.y = record.scroll;
+            break;
+        default:
+            break;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "save_game.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// One recorded input event: the subset of SDL_Event that Game::handleEvent reads
+struct InputEventRecord {
+    Uint32 tick;           // Ticks since the recording started; the event is handled before that tick runs
+    Uint32 type;           // SDL_EventType
+    Uint16 code;           // Scancode (keys) or mouse button
+    Uint16 mod;            // Key modifiers
+    float x, y;            // Mouse position
+    float scroll;          // Mouse wheel: vertical scroll amount
+};
+
+// Writes an input recording: a header, the board the recording starts from (in
+// the save file layout) and one fixed-width record per handled input event. Both
+// sessions must use the same content; contentHash lets replay detect a mismatch.
+// The header also carries the SimRandom seed, which replay starts from.
+class InputRecorder {
+private:
+    FILE* file;
+    std::string path;
+    Uint64 contentHash;
+    Uint64 seed;
+    Uint32 saveSize;
+    Uint32 eventCount;
+
+    bool writeHeader(Uint64 tickCount);
+
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool start(const std::string& recordingPath, Uint64 sourceHash, Uint64 randomSeed, const SaveData& startBoard);
+    // Events of types handleEvent ignores are not recorded
+    void record(const SDL_Event& e, Uint64 tick);
+    // Stores the recording's length in ticks and closes the file
+    void stop(Uint64 tickCount);
+    bool isActive() const { return file != nullptr; }
+};
+
+// A loaded recording, fed back to Game::handleEvent tick by tick
+class InputReplay {
+private:
+    std::vector<InputEventRecord> events;
+    size_t nextEvent;
+    Uint64 tickCount;
+
+public:
+    SaveData startBoard;
+    Uint64 contentHash;
+    Uint64 seed;
+
+    InputReplay();
+
+    bool load(const std::string& path);
+    // Returns the next event due at or before `tick`, if any
+    bool next(Uint64 tick, SDL_Event& e);
+    // True once every event was handed out and the recorded length has elapsed
+    bool isFinished(Uint64 tick) const { return nextEvent == events.size() && tick >= tickCount; }
+    bool isActive() const { return !events.empty() || tickCount > 0; }
+    size_t getEventCount() const { return events.size(); }
+    Uint64 getTickCount() const { return tickCount; }
+};
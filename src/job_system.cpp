@@ -0,0 +1,138 @@
+#include "job_system.h"
+#include "debug.h"
+#include "alloc_tracker.h"
+
+static thread_local int currentThreadIndex = 0;
+
+JobSystem::JobSystem() : running(false), queuedJobs(0) {
+    queues.emplace_back(new WorkerQueue());
+}
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+void JobSystem::start(int workerCount) {
+    if (running) return;
+    if (workerCount <= 0) {
+        int hardware = (int)std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    running = true;
+    for (int i = 1; i <= workerCount; i++) {
+        queues.emplace_back(new WorkerQueue());
+    }
+    for (int i = 1; i <= workerCount; i++) {
+        threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+    DEBUG_PRINT("Job system started with %d worker threads\n", workerCount);
+}
+
+void JobSystem::stop() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    queues.resize(1);
+}
+
+int JobSystem::getThreadIndex() {
+    return currentThreadIndex;
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, RangeFn fn, void* context) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+
+    // Not worth waking anyone for a single chunk
+    if (threads.empty() || count <= grain) {
+        fn(context, 0, count);
+        return;
+    }
+
+    size_t chunks = (count + grain - 1) / grain;
+    std::atomic<size_t> remaining(chunks);
+
+    // Deal chunks round-robin so every thread starts with local work
+    int self = currentThreadIndex;
+    size_t queueCount = queues.size();
+    for (size_t c = 0; c < chunks; c++) {
+        Job job;
+        job.fn = fn;
+        job.context = context;
+        job.begin = c * grain;
+        job.end = job.begin + grain < count ? job.begin + grain : count;
+        job.remaining = &remaining;
+
+        WorkerQueue& queue = *queues[(self + c) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedJobs += (int)chunks;
+    }
+    wake.notify_all();
+
+    // Help until our chunks are done (this may also run other callers' jobs)
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(int index) {
+    currentThreadIndex = index;
+    AllocTracker::setFrameThread(true);
+    while (true) {
+        if (runOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return !running || queuedJobs > 0; });
+        if (!running) return;
+    }
+}
+
+bool JobSystem::runOne(int self) {
+    Job job;
+    if (!popJob(self, job)) return false;
+
+    queuedJobs--;
+    job.fn(job.context, job.begin, job.end);
+    job.remaining->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+bool JobSystem::popJob(int self, Job& job) {
+    // Own queue first, newest job (still warm in cache)
+    {
+        WorkerQueue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest job from someone else
+    size_t queueCount = queues.size();
+    for (size_t i = 1; i < queueCount; i++) {
+        WorkerQueue& victim = *queues[(self + i) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
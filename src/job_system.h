@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work-stealing thread pool for the parallel phases of the simulation.
+// Each thread (the calling thread is slot 0) owns a deque of range jobs: it pops
+// its own work from the back and steals from the front of other deques when idle.
+// parallelFor() splits [0, count) into chunks, lets the caller help, and returns
+// only once every chunk has finished, so callers see a plain fork/join.
+class JobSystem {
+public:
+    typedef void (*RangeFn)(void* context, size_t begin, size_t end);
+
+private:
+    struct Job {
+        RangeFn fn;
+        void* context;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t>* remaining;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues; // [0] = calling thread, [1..] = workers
+    std::vector<std::thread> threads;
+    std::atomic<bool> running;
+    std::atomic<int> queuedJobs;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    void workerLoop(int index);
+    bool runOne(int self);
+    bool popJob(int self, Job& job);
+
+public:
+    JobSystem();
+    ~JobSystem();
+
+    // Starts workerCount background threads (0 = hardware threads - 1)
+    void start(int workerCount = 0);
+    void stop();
+
+    // Threads that execute jobs, including the caller
+    int getThreadCount() const { return (int)threads.size() + 1; }
+    // Index of the current thread in [0, getThreadCount()); 0 for any non-worker thread
+    static int getThreadIndex();
+
+    void parallelFor(size_t count, size_t grain, RangeFn fn, void* context);
+
+    // body(begin, end) is called for disjoint chunks of at most `grain` items
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body&& body) {
+        typedef typename std::remove_reference<Body>::type BodyType;
+        parallelFor(count, grain, [](void* context, size_t begin, size_t end) {
+            (*static_cast<BodyType*>(context))(begin, end);
+        }, (void*)&body);
+    }
+};
@@ -0,0 +1,298 @@
+#include "journal.h"
+#include "config_parser.h"
+#include <SDL3/SDL_timer.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+static_assert(sizeof(JournalEntry) == 56, "JournalEntry layout changed; old journals would misparse");
+
+Journal::Journal() : queue(1 << 16), sequence(0), tick(0), durableSequence(0), active(false), overflowHead(0),
+                     running(false), file(nullptr), segmentIndex(0) {}
+
+Journal::~Journal() {
+    stop();
+}
+
+bool Journal::start(const std::string& journalBasePath) {
+    if (active) return true;
+    basePath = journalBasePath;
+    sequence = 0;
+    durableSequence = 0;
+    segmentIndex = 0;
+    closed.clear();
+    if (!openSegment()) {
+        printf("[JOURNAL] Could not open %s\n", current.path.c_str());
+        return false;
+    }
+
+    active = true;
+    running = true;
+    thread = std::thread(&Journal::writeLoop, this);
+    return true;
+}
+
+void Journal::stop() {
+    if (!active) return;
+    // Shutting down may wait on the writer; the spilled tail still has to reach the file
+    while (!overflow.empty()) {
+        drainOverflow();
+        if (!overflow.empty()) SDL_Delay(1);
+    }
+    running = false;
+    thread.join();
+    active = false;
+
+    // A clean shutdown needs no recovery
+    if (file) fclose(file);
+    file = nullptr;
+    closed.push_back(current);
+    for (const Segment& segment : closed) {
+        std::error_code error;
+        std::filesystem::remove(segment.path, error);
+    }
+    closed.clear();
+    std::error_code error;
+    std::filesystem::remove(snapshotPath(basePath), error);
+}
+
+void Journal::append(JournalEntry entry) {
+    if (!active) return;
+    entry.sequence = ++sequence;
+    entry.tick = tick;
+    push(entry);
+}
+
+void Journal::rotate() {
+    if (!active) return;
+    JournalEntry marker = {};
+    marker.op = JournalOp::ROTATE;
+    marker.sequence = sequence; // Not a new entry; marks the end of the current segment
+    push(marker);
+}
+
+void Journal::push(const JournalEntry& entry) {
+    // Once anything has spilled, later entries queue up behind it to keep the order
+    if (!overflow.empty()) drainOverflow();
+    if (overflow.empty() && queue.push(entry)) return;
+    overflow.push_back(entry);
+}
+
+void Journal::drainOverflow() {
+    while (overflowHead < overflow.size() && queue.push(overflow[overflowHead])) {
+        overflowHead++;
+    }
+    if (overflowHead == overflow.size()) {
+        overflow.clear();
+        overflowHead = 0;
+    }
+}
+
+bool Journal::openSegment() {
+    current.path = basePath + "." + std::to_string(segmentIndex++) + ".log";
+    current.lastSequence = 0;
+    file = fopen(current.path.c_str(), "wb");
+    if (file) {
+        setvbuf(file, nullptr, _IOFBF, 64 * 1024);
+    }
+    return file != nullptr;
+}
+
+void Journal::removeCoveredSegments() {
+    Uint64 durable = durableSequence.load(std::memory_order_acquire);
+    auto covered = [durable](const Segment& segment) {
+        if (segment.lastSequence > durable) return false;
+        std::error_code error;
+        std::filesystem::remove(segment.path, error);
+        return true;
+    };
+    closed.erase(std::remove_if(closed.begin(), closed.end(), covered), closed.end());
+}
+
+void Journal::writeLoop() {
+    JournalEntry entry;
+    bool unflushed = false;
+    while (true) {
+        bool drained = false;
+        while (queue.pop(entry)) {
+            if (entry.op == JournalOp::ROTATE) {
+                if (file) fclose(file);
+                closed.push_back(current);
+                if (!openSegment()) {
+                    // Keep draining so the producer never stalls; entries are lost until the next rotation
+                    printf("[JOURNAL] Could not open %s\n", current.path.c_str());
+                }
+                continue;
+            }
+            if (!file) continue;
+            fwrite(&entry, sizeof(entry), 1, file);
+            current.lastSequence = entry.sequence;
+            unflushed = true;
+            drained = true;
+        }
+
+        // Flush each batch as soon as the queue runs dry so a crash loses at most one batch
+        if (unflushed) {
+            fflush(file);
+            unflushed = false;
+        }
+        if (!closed.empty()) {
+            removeCoveredSegments();
+        }
+        if (!drained) {
+            if (!running && queue.empty()) return;
+            SDL_Delay(2);
+        }
+    }
+}
+
+std::vector<std::string> Journal::findSegments(const std::string& journalBasePath) {
+    std::filesystem::path base(journalBasePath);
+    std::filesystem::path directory = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+    std::string prefix = base.filename().string() + ".";
+
+    std::vector<std::pair<int, std::string>> found;
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = item.path().filename().string();
+        if (name.size() <= prefix.size() + 4 || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - 4, 4, ".log") != 0) {
+            continue;
+        }
+        int index = parseIntView(std::string_view(name).substr(prefix.size(), name.size() - prefix.size() - 4), -1);
+        if (index >= 0) {
+            found.push_back({index, item.path().string()});
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    std::vector<std::string> segments;
+    for (const auto& segment : found) {
+        segments.push_back(segment.second);
+    }
+    return segments;
+}
+
+void Journal::removeSegments(const std::vector<std::string>& segments) {
+    for (const std::string& segment : segments) {
+        std::error_code error;
+        std::filesystem::remove(segment, error);
+    }
+}
+
+size_t Journal::replay(const std::vector<std::string>& segments, SaveData& data) {
+    struct ReplayCraft {
+        Sint32 recipeIndex;
+        Uint32 durationTicks;
+        Uint64 endTick;
+        SDL_FRect barRect;
+    };
+
+    // Cards keep a z-order key so moving one to the front doesn't shift the rest
+    std::vector<SaveCardRecord> cards = data.cards;
+    std::vector<Uint64> order(cards.size());
+    std::vector<Uint8> live(cards.size(), 1);
+    std::unordered_map<Uint32, size_t> byId;
+    for (size_t i = 0; i < cards.size(); i++) {
+        order[i] = i;
+        byId[cards[i].id] = i;
+    }
+    Uint64 nextOrder = cards.size();
+
+    std::unordered_map<Uint32, ReplayCraft> crafts;
+    for (const SaveStackRecord& stack : data.stacks) {
+        if (stack.recipeIndex >= 0) {
+            crafts[stack.stackId] = {stack.recipeIndex, stack.durationTicks, data.tick + stack.remainingTicks, stack.barRect};
+        }
+    }
+
+    size_t applied = 0;
+    Uint64 lastTick = data.tick;
+    std::string text;
+    for (const std::string& path : segments) {
+        if (!readConfigFile(path, text)) continue;
+        size_t count = text.size() / sizeof(JournalEntry); // A torn final record is ignored
+        for (size_t i = 0; i < count; i++) {
+            JournalEntry entry;
+            memcpy(&entry, text.data() + i * sizeof(JournalEntry), sizeof(entry));
+            if (entry.sequence <= data.journalSequence) continue;
+            applied++;
+            lastTick = entry.tick;
+
+            switch (entry.op) {
+                case JournalOp::CARD: {
+                    SaveCardRecord record = {entry.id, entry.stackId, entry.type, entry.count, entry.x, entry.y, entry.baseX, entry.baseY};
+                    auto it = byId.find(entry.id);
+                    if (it == byId.end() || !live[it->second]) {
+                        byId[entry.id] = cards.size();
+                        cards.push_back(record);
+                        order.push_back(nextOrder++);
+                        live.push_back(1);
+                    } else if (entry.flags & JOURNAL_STACK_ONLY) {
+                        cards[it->second].stackId = entry.stackId;
+                    } else {
+                        cards[it->second] = record;
+                        if (entry.flags & JOURNAL_TO_FRONT) order[it->second] = nextOrder++;
+                    }
+                    data.nextCardId = std::max(data.nextCardId, entry.id + 1);
+                    break;
+                }
+                case JournalOp::ERASE: {
+                    auto it = byId.find(entry.id);
+                    if (it != byId.end()) live[it->second] = 0;
+                    break;
+                }
+                case JournalOp::CRAFT_START:
+                    crafts[entry.id] = {entry.recipeIndex, entry.durationTicks, entry.tick + entry.durationTicks,
+                                        {entry.x, entry.y, entry.baseX, entry.baseY}};
+                    break;
+                case JournalOp::CRAFT_END:
+                    crafts.erase(entry.id);
+                    break;
+                case JournalOp::RESET:
+                    std::fill(live.begin(), live.end(), 0);
+                    crafts.clear();
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // Rebuild the snapshot arrays in z-order
+    std::vector<size_t> sorted;
+    sorted.reserve(cards.size());
+    for (size_t i = 0; i < cards.size(); i++) {
+        if (live[i]) sorted.push_back(i);
+    }
+    std::sort(sorted.begin(), sorted.end(), [&order](size_t a, size_t b) { return order[a] < order[b]; });
+    data.cards.clear();
+    for (size_t index : sorted) {
+        data.cards.push_back(cards[index]);
+    }
+
+    std::unordered_map<Uint32, size_t> stackIndex;
+    data.stacks.clear();
+    for (const SaveCardRecord& card : data.cards) {
+        auto inserted = stackIndex.emplace(card.stackId, data.stacks.size());
+        if (inserted.second) {
+            SaveStackRecord stack = {};
+            stack.stackId = card.stackId;
+            stack.recipeIndex = -1;
+            data.stacks.push_back(stack);
+        }
+        data.stacks[inserted.first->second].cardCount++;
+    }
+    for (const auto& entry : crafts) {
+        auto it = stackIndex.find(entry.first);
+        if (it == stackIndex.end()) continue;
+        SaveStackRecord& stack = data.stacks[it->second];
+        stack.recipeIndex = entry.second.recipeIndex;
+        stack.durationTicks = entry.second.durationTicks;
+        stack.remainingTicks = entry.second.endTick > lastTick ? (Uint32)(entry.second.endTick - lastTick) : 1;
+        stack.barRect = entry.second.barRect;
+    }
+    data.tick = lastTick;
+    return applied;
+}
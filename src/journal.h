@@ -0,0 +1,110 @@
+#pragma once
+
+#include "save_game.h"
+#include "spsc_queue.h"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class JournalOp : Uint16 {
+    CARD,          // Card created or changed: id, stackId, type, count, position, base position
+    ERASE,         // Card removed from the playmat
+    CRAFT_START,   // Craft scheduled on stack `id`; x/y/baseX/baseY hold the progress bar rect
+    CRAFT_END,     // Craft on stack `id` completed or cancelled
+    RESET,         // The whole board was replaced (quickload); CARD/CRAFT_START entries follow
+    ROTATE         // Writer-only marker: start a new segment
+};
+
+// JournalEntry::flags
+const Uint16 JOURNAL_TO_FRONT = 1;        // CARD: the card moved to the top of the z-order
+const Uint16 JOURNAL_STACK_ONLY = 2;      // CARD: only the stack id changed; keep the recorded position
+
+// One fixed-width journal record
+struct JournalEntry {
+    Uint64 sequence;       // Increases by one per entry across the whole session
+    Uint64 tick;           // Simulation tick the mutation happened on
+    JournalOp op;
+    Uint16 flags;
+    Uint32 id;             // Card id, or stack id for craft entries
+    Uint32 stackId;
+    Uint32 type;
+    Sint32 recipeIndex;
+    union {
+        Uint32 durationTicks;  // CRAFT_START
+        Uint32 count;          // CARD: pile size (0 reads as 1)
+    };
+    float x, y;
+    float baseX, baseY;
+};
+
+// Write-ahead log of board mutations since the last base snapshot. The simulation appends
+// entries through a lock-free SPSC queue; a writer thread drains it into a
+// buffered segment file (<base>.<n>.log) and flushes whenever the queue runs dry.
+// A burst larger than the queue (a quickload of a big board) spills into an
+// overflow buffer on the simulation side, which later ticks feed to the queue,
+// so appending never waits on the disk.
+// Each base snapshot (<base>.base.sav, written by Game apart from the player's
+// autosave) starts a new segment, and once that snapshot is on disk every older
+// segment is deleted, so the journal only ever covers the time since the last
+// durable snapshot. After a crash, replay() re-applies the surviving segments on
+// top of that snapshot.
+class Journal {
+private:
+    struct Segment {
+        std::string path;
+        Uint64 lastSequence;
+    };
+
+    SpscQueue<JournalEntry> queue;
+    std::string basePath;
+    Uint64 sequence;                       // Last sequence handed out (producer side)
+    Uint64 tick;                           // Stamped onto appended entries
+    std::atomic<Uint64> durableSequence;   // Highest sequence covered by a snapshot on disk
+    bool active;
+    std::vector<JournalEntry> overflow;    // Producer side: entries the full queue refused, oldest first
+    size_t overflowHead;                   // First entry of `overflow` not yet in the queue
+
+    // Writer thread state
+    std::thread thread;
+    std::atomic<bool> running;
+    FILE* file;
+    Segment current;
+    std::vector<Segment> closed;
+    int segmentIndex;
+
+    void writeLoop();
+    void push(const JournalEntry& entry);
+    void drainOverflow();
+    bool openSegment();
+    void removeCoveredSegments();
+
+public:
+    Journal();
+    ~Journal();
+
+    // Starts a fresh journal; any existing segments for basePath should be handled first
+    bool start(const std::string& journalBasePath);
+    // Writes everything still queued, then closes the segment and removes all segments and the snapshot
+    void stop();
+    bool isActive() const { return active; }
+
+    // Called once per tick; also feeds the queue whatever an earlier burst spilled
+    void setTick(Uint64 currentTick) {
+        tick = currentTick;
+        if (!overflow.empty()) drainOverflow();
+    }
+    void append(JournalEntry entry);
+    Uint64 getSequence() const { return sequence; }
+    // Closes the current segment; called when a base snapshot is captured
+    void rotate();
+    // Tells the writer that a snapshot containing every entry up to `covered` is on disk
+    void markDurable(Uint64 covered) { durableSequence.store(covered, std::memory_order_release); }
+
+    static std::string snapshotPath(const std::string& journalBasePath) { return journalBasePath + ".base.sav"; }
+    static std::vector<std::string> findSegments(const std::string& journalBasePath);
+    static void removeSegments(const std::vector<std::string>& segments);
+    // Applies every entry newer than data.journalSequence; returns the number applied
+    static size_t replay(const std::vector<std::string>& segments, SaveData& data);
+};
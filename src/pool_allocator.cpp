@@ -0,0 +1,86 @@
+#include "pool_allocator.h"
+#include <mutex>
+
+// Chunks are sized to hold at least this many bytes (and at least a few blocks)
+static const size_t POOL_CHUNK_BYTES = 64 * 1024;
+
+// Pools register themselves for reporting; the list only changes when a pool is first used
+static std::mutex& registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::vector<FixedBlockPool*>& registry() {
+    static std::vector<FixedBlockPool*> pools;
+    return pools;
+}
+
+FixedBlockPool::FixedBlockPool(const char* poolName, size_t size, size_t alignment)
+    : name(poolName), freeList(nullptr), live(0), peak(0), allocations(0) {
+    // Every block must hold a free-list link and keep the next block aligned
+    if (size < sizeof(FreeBlock)) size = sizeof(FreeBlock);
+    if (alignment < alignof(FreeBlock)) alignment = alignof(FreeBlock);
+    blockSize = (size + alignment - 1) / alignment * alignment;
+    blocksPerChunk = POOL_CHUNK_BYTES / blockSize;
+    if (blocksPerChunk < 8) blocksPerChunk = 8;
+
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().push_back(this);
+}
+
+FixedBlockPool::~FixedBlockPool() {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        std::vector<FixedBlockPool*>& pools = registry();
+        for (size_t i = 0; i < pools.size(); i++) {
+            if (pools[i] == this) {
+                pools.erase(pools.begin() + i);
+                break;
+            }
+        }
+    }
+    for (char* chunk : chunks) {
+        delete[] chunk;
+    }
+}
+
+void FixedBlockPool::grow() {
+    // new[] storage is max_align_t aligned, and blockSize is a multiple of the block alignment
+    char* chunk = new char[blockSize * blocksPerChunk];
+    chunks.push_back(chunk);
+    // Thread the new blocks onto the free list in address order
+    for (size_t i = blocksPerChunk; i > 0; i--) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * blockSize);
+        block->next = freeList;
+        freeList = block;
+    }
+}
+
+void* FixedBlockPool::allocate() {
+    if (!freeList) grow();
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    live++;
+    if (live > peak) peak = live;
+    allocations++;
+    return block;
+}
+
+void FixedBlockPool::release(void* block) {
+    if (!block) return;
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeList;
+    freeList = freed;
+    live--;
+}
+
+PoolStats FixedBlockPool::getStats() const {
+    return {name, blockSize, chunks.size() * blocksPerChunk, live, peak, allocations};
+}
+
+void FixedBlockPool::collectStats(std::vector<PoolStats>& out) {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (const FixedBlockPool* pool : registry()) {
+        out.push_back(pool->getStats());
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <SDL3/SDL_stdinc.h>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Occupancy of one pool, for the --profile and bot reports
+struct PoolStats {
+    const char* name;
+    size_t blockSize;
+    size_t capacity;       // Blocks carved out so far
+    size_t live;           // Blocks in use
+    size_t peak;           // Most blocks in use at once
+    Uint64 allocations;    // Lifetime allocate() calls
+};
+
+// Fixed-size block allocator. Blocks are carved from large chunks that stay
+// with the pool, and released blocks go on an intrusive free list, so allocate
+// and release are O(1) and churn doesn't fragment the heap. Once the pool has
+// grown to its peak occupancy it stops touching the heap. Not thread-safe:
+// everything that uses one pool must run on one thread at a time.
+class FixedBlockPool {
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    const char* name;
+    size_t blockSize;
+    size_t blocksPerChunk;
+    std::vector<char*> chunks;
+    FreeBlock* freeList;
+    size_t live;
+    size_t peak;
+    Uint64 allocations;
+
+    void grow();
+
+public:
+    FixedBlockPool(const char* poolName, size_t size, size_t alignment);
+    ~FixedBlockPool();
+    FixedBlockPool(const FixedBlockPool&) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+    void* allocate();
+    void release(void* block);
+    PoolStats getStats() const;
+
+    // Appends the stats of every pool created so far
+    static void collectStats(std::vector<PoolStats>& out);
+};
+
+// Standard allocator that serves single-object allocations (container nodes,
+// allocate_shared blocks) from a FixedBlockPool and anything larger (bucket and
+// array storage) from the heap. There is one pool per (value type, Tag); Tag
+// supplies the report name through a static `name` member.
+template <typename T, typename Tag>
+class PoolAllocator {
+public:
+    using value_type = T;
+    template <typename U>
+    struct rebind {
+        using other = PoolAllocator<U, Tag>;
+    };
+
+    PoolAllocator() noexcept {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n == 1) return static_cast<T*>(pool().allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        if (n == 1) {
+            pool().release(p);
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    static FixedBlockPool& pool() {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Pool chunks are only max_align_t aligned");
+        static FixedBlockPool instance(Tag::name, sizeof(T), alignof(T));
+        return instance;
+    }
+};
+
+template <typename T, typename U, typename Tag>
+bool operator==(const PoolAllocator<T, Tag>&, const PoolAllocator<U, Tag>&) { return true; }
+template <typename T, typename U, typename Tag>
+bool operator!=(const PoolAllocator<T, Tag>&, const PoolAllocator<U, Tag>&) { return false; }
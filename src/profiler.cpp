@@ -0,0 +1,90 @@
+#include "profiler.h"
+#include "alloc_tracker.h"
+#include <SDL3/SDL_timer.h>
+#include <cstdio>
+
+Profiler::Profiler() : frames(0), windowStart(0), reporting(false), reportSeconds(5.0), windowAllocations(0),
+                       lastFrameAllocations(0), lastFrameBytes(0) {}
+
+Profiler& Profiler::get() {
+    static Profiler instance;
+    return instance;
+}
+
+void Profiler::setReporting(bool enabled, double intervalSeconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    reporting = enabled;
+    reportSeconds = intervalSeconds;
+    windowStart = SDL_GetTicksNS();
+}
+
+void Profiler::record(const char* name, Uint64 elapsedNS, Uint64 allocations, Uint64 allocatedBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (ScopeStats& scope : scopes) {
+        if (scope.name == name) {
+            scope.calls++;
+            scope.totalNS += elapsedNS;
+            if (elapsedNS > scope.maxNS) scope.maxNS = elapsedNS;
+            scope.allocations += allocations;
+            scope.allocatedBytes += allocatedBytes;
+            scope.frameAllocations += allocations;
+            return;
+        }
+    }
+    scopes.push_back({name, 1, elapsedNS, elapsedNS, allocations, allocatedBytes, allocations, 0});
+}
+
+bool Profiler::endFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    frames++;
+    AllocTracker::Counts frameCounts = AllocTracker::takeFrameCounts();
+    lastFrameAllocations = frameCounts.allocations;
+    lastFrameBytes = frameCounts.bytes;
+    windowAllocations += frameCounts.allocations;
+    for (ScopeStats& scope : scopes) {
+        scope.lastFrameAllocations = scope.frameAllocations;
+        scope.frameAllocations = 0;
+    }
+    if (!reporting) return false;
+
+    Uint64 now = SDL_GetTicksNS();
+    double elapsed = (now - windowStart) / 1e9;
+    if (elapsed < reportSeconds) return false;
+
+    printf("[PROFILE] %llu frames in %.1f s (%.1f fps), %.1f allocs/frame\n", (unsigned long long)frames, elapsed,
+           frames / elapsed, (double)windowAllocations / frames);
+    for (ScopeStats& scope : scopes) {
+        if (scope.calls == 0) continue;
+        printf("[PROFILE]   %-24s %8.3f ms/frame  %8.3f ms max  %6llu calls  %8.1f allocs/frame  %10.0f B/frame\n",
+               scope.name, scope.totalNS / 1e6 / frames, scope.maxNS / 1e6, (unsigned long long)scope.calls,
+               (double)scope.allocations / frames, (double)scope.allocatedBytes / frames);
+        scope.calls = 0;
+        scope.totalNS = 0;
+        scope.maxNS = 0;
+        scope.allocations = 0;
+        scope.allocatedBytes = 0;
+    }
+    frames = 0;
+    windowAllocations = 0;
+    windowStart = now;
+    return true;
+}
+
+void Profiler::printLastFrameAllocations() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const ScopeStats& scope : scopes) {
+        if (scope.lastFrameAllocations == 0) continue;
+        printf("[ALLOC]   %-24s %llu allocations\n", scope.name, (unsigned long long)scope.lastFrameAllocations);
+    }
+}
+
+ProfileScope::ProfileScope(const char* scopeName) : name(scopeName), start(SDL_GetTicksNS()) {
+    AllocTracker::Counts counts = AllocTracker::getThreadCounts();
+    startAllocations = counts.allocations;
+    startBytes = counts.bytes;
+}
+
+ProfileScope::~ProfileScope() {
+    AllocTracker::Counts counts = AllocTracker::getThreadCounts();
+    Profiler::get().record(name, SDL_GetTicksNS() - start, counts.allocations - startAllocations, counts.bytes - startBytes);
+}
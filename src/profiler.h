@@ -0,0 +1,70 @@
+#pragma once
+
+#include <SDL3/SDL_stdinc.h>
+#include <mutex>
+#include <vector>
+
+// Lightweight scope profiler. PROFILE_SCOPE("name") times the enclosing block
+// and counts the heap allocations the calling thread made inside it (see
+// alloc_tracker.h); the totals are summed per frame and printed as per-frame
+// averages every few seconds when reporting is enabled (--profile). Scope names
+// must be string literals: entries are keyed by the pointer.
+class Profiler {
+public:
+    struct ScopeStats {
+        const char* name;
+        Uint64 calls;
+        Uint64 totalNS;
+        Uint64 maxNS;       // Longest single call
+        Uint64 allocations; // Heap allocations made inside the scope (nested scopes included)
+        Uint64 allocatedBytes;
+        Uint64 frameAllocations;     // Allocations during the frame in progress
+        Uint64 lastFrameAllocations; // ... and during the last completed frame
+    };
+
+private:
+    std::mutex mutex;       // Scopes may close on the simulation and render threads at once
+    std::vector<ScopeStats> scopes;
+    Uint64 frames;
+    Uint64 windowStart;
+    bool reporting;
+    double reportSeconds;
+    Uint64 windowAllocations;      // Frame-thread allocations since the last report
+    Uint64 lastFrameAllocations;
+    Uint64 lastFrameBytes;
+
+    Profiler();
+
+public:
+    static Profiler& get();
+
+    void record(const char* name, Uint64 elapsedNS, Uint64 allocations, Uint64 allocatedBytes);
+    // Called once per presented frame; prints and resets the stats when the report interval has passed.
+    // Returns true on frames that printed a report.
+    bool endFrame();
+
+    // Heap allocations made on frame threads during the last completed frame
+    Uint64 getLastFrameAllocations() const { return lastFrameAllocations; }
+    Uint64 getLastFrameBytes() const { return lastFrameBytes; }
+    // Prints every scope that allocated during the last completed frame
+    void printLastFrameAllocations();
+
+    void setReporting(bool enabled, double intervalSeconds = 5.0);
+    bool isReporting() const { return reporting; }
+};
+
+class ProfileScope {
+private:
+    const char* name;
+    Uint64 start;
+    Uint64 startAllocations;
+    Uint64 startBytes;
+
+public:
+    explicit ProfileScope(const char* scopeName);
+    ~ProfileScope();
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
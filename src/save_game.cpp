@@ -0,0 +1,145 @@
+#include "save_game.h"
+#include "config_parser.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Bump whenever a record layout changes; older saves are then rejected
+static const Uint32 SAVE_VERSION = 2;
+static const char SAVE_MAGIC[4] = {'S', 'L', 'S', 'V'};
+
+struct SaveHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 cardCount;
+    Uint32 handCount;
+    Uint32 stackCount;
+    Uint32 nextCardId;
+    Uint64 tick;
+    Uint64 journalSequence;
+};
+
+static_assert(sizeof(SaveHeader) == 40, "SaveHeader layout changed; bump SAVE_VERSION");
+static_assert(sizeof(SaveCardRecord) == 32 && sizeof(SaveStackRecord) == 36, "Save record layout changed; bump SAVE_VERSION");
+
+template <typename T>
+static void appendArray(std::string& blob, const std::vector<T>& records) {
+    blob.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T));
+}
+
+template <typename T>
+static void copyArray(const char*& cursor, Uint32 count, std::vector<T>& records) {
+    records.resize(count);
+    if (count > 0) memcpy(records.data(), cursor, (size_t)count * sizeof(T));
+    cursor += (size_t)count * sizeof(T);
+}
+
+bool encodeSave(const SaveData& data, std::string& blob) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    printf("[SAVE] Saving is only supported on little-endian hosts\n");
+    return false;
+#else
+    SaveHeader header = {};
+    memcpy(header.magic, SAVE_MAGIC, sizeof(SAVE_MAGIC));
+    header.version = SAVE_VERSION;
+    header.cardCount = (Uint32)data.cards.size();
+    header.handCount = (Uint32)data.handCards.size();
+    header.stackCount = (Uint32)data.stacks.size();
+    header.nextCardId = data.nextCardId;
+    header.tick = data.tick;
+    header.journalSequence = data.journalSequence;
+
+    blob.clear();
+    blob.reserve(sizeof(header) + (data.cards.size() + data.handCards.size()) * sizeof(SaveCardRecord) +
+                 data.stacks.size() * sizeof(SaveStackRecord));
+    blob.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    appendArray(blob, data.cards);
+    appendArray(blob, data.handCards);
+    appendArray(blob, data.stacks);
+    return true;
+#endif
+}
+
+bool decodeSave(const char* bytes, size_t size, const std::string& source, SaveData& data) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    printf("[SAVE] Loading is only supported on little-endian hosts\n");
+    return false;
+#else
+    SaveHeader header;
+    if (size < sizeof(header)) {
+        printf("[SAVE] %s is not a save file\n", source.c_str());
+        return false;
+    }
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, SAVE_MAGIC, sizeof(SAVE_MAGIC)) != 0) {
+        printf("[SAVE] %s is not a save file\n", source.c_str());
+        return false;
+    }
+    if (header.version != SAVE_VERSION) {
+        printf("[SAVE] %s has version %u, expected %u\n", source.c_str(), header.version, SAVE_VERSION);
+        return false;
+    }
+
+    Uint64 expectedSize = sizeof(header) + ((Uint64)header.cardCount + header.handCount) * sizeof(SaveCardRecord) +
+                          (Uint64)header.stackCount * sizeof(SaveStackRecord);
+    if (expectedSize != size) {
+        printf("[SAVE] %s is truncated or damaged\n", source.c_str());
+        return false;
+    }
+
+    const char* cursor = bytes + sizeof(header);
+    copyArray(cursor, header.cardCount, data.cards);
+    copyArray(cursor, header.handCount, data.handCards);
+    copyArray(cursor, header.stackCount, data.stacks);
+    data.nextCardId = header.nextCardId;
+    data.tick = header.tick;
+    data.journalSequence = header.journalSequence;
+    return true;
+#endif
+}
+
+bool writeSaveFile(const std::string& path, const SaveData& data) {
+    std::string blob;
+    if (!encodeSave(data, blob)) return false;
+
+    // Write next to the target and rename, so an interrupted save keeps the previous file
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        printf("[SAVE] Could not open %s for writing\n", tempPath.c_str());
+        return false;
+    }
+    bool written = fwrite(blob.data(), 1, blob.size(), file) == blob.size() && fflush(file) == 0;
+    // Make the data durable before the rename publishes it
+#ifdef _WIN32
+    written = written && _commit(_fileno(file)) == 0;
+#else
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    written = (fclose(file) == 0) && written;
+
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(tempPath, path, error);
+    }
+    if (!written || error) {
+        printf("[SAVE] Could not write %s\n", path.c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool readSaveFile(const std::string& path, SaveData& data) {
+    std::string blob;
+    if (!readConfigFile(path, blob)) {
+        printf("[SAVE] Could not open %s\n", path.c_str());
+        return false;
+    }
+    return decodeSave(blob.data(), blob.size(), path, data);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "common.h"
+#include <string>
+#include <vector>
+
+// On-disk record for one card. Playmat cards are stored back to front, so the
+// record order is the z-order.
+struct SaveCardRecord {
+    Uint32 id;
+    Uint32 stackId;
+    Uint32 type;
+    Uint32 count;          // Cards in the pile; older saves wrote 0 here, which reads as 1
+    float x, y;            // Current position
+    float baseX, baseY;    // Rest position within the stack
+};
+
+// On-disk record for one stack on the playmat (every card is in exactly one stack)
+struct SaveStackRecord {
+    Uint32 stackId;
+    Uint32 cardCount;
+    Sint32 recipeIndex;    // Craft in progress, or -1
+    Uint32 remainingTicks; // Ticks until the craft completes
+    Uint32 durationTicks;
+    SDL_FRect barRect;     // Where the craft's progress bar is drawn
+};
+
+// Complete board state in the save file layout. Game fills the arrays directly,
+// so writing is one bulk copy per array and reading is the reverse.
+struct SaveData {
+    std::vector<SaveCardRecord> cards;
+    std::vector<SaveCardRecord> handCards;
+    std::vector<SaveStackRecord> stacks;
+    Uint32 nextCardId;
+    Uint64 tick;
+    Uint64 journalSequence;   // Last journal entry already reflected in this state (0 if none)
+
+    SaveData() : nextCardId(1), tick(0), journalSequence(0) {}
+};
+
+// Versioned little-endian save files: a fixed header followed by the card, hand
+// and stack arrays. Both return false (and print why) on failure; a failed read
+// leaves `data` in an unspecified state.
+bool writeSaveFile(const std::string& path, const SaveData& data);
+bool readSaveFile(const std::string& path, SaveData& data);
+
+// The same layout in memory, for formats that embed a board (e.g. input recordings).
+// `source` names the data in error messages.
+bool encodeSave(const SaveData& data, std::string& blob);
+bool decodeSave(const char* bytes, size_t size, const std::string& source, SaveData& data);
@@ -0,0 +1,179 @@
+#include "scenario.h"
+#include "card.h"
+#include "config_parser.h"
+#include "sim_random.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+ScenarioSpec::ScenarioSpec() : seed(1), cardCount(1000), areaWidth(1920.0f), areaHeight(900.0f),
+                               clusterCount(0), clusterRadius(300.0f), clusteredFraction(0.0f), craftFraction(0.0f),
+                               pileFraction(0.0f), pileMaxCount(100) {
+    for (int i = 0; i < CARD_TYPE_COUNT; i++) typeWeights[i] = 1.0f;
+    stackDepthWeights.push_back(1.0f);
+}
+
+bool loadScenario(const std::string& path, ScenarioSpec& spec) {
+    std::string text;
+    if (!readConfigFile(path, text)) {
+        printf("[SCENARIO] Could not open %s\n", path.c_str());
+        return false;
+    }
+    JsonDocument document;
+    if (!document.parse(text) || document.getRoot()->type != JsonType::OBJECT) {
+        printf("[SCENARIO] Could not parse %s: %s\n", path.c_str(), document.getError().c_str());
+        return false;
+    }
+    const JsonNode* root = document.getRoot();
+
+    spec = ScenarioSpec();
+    spec.name = path;
+    if (const JsonNode* name = document.find(root, "name")) spec.name = JsonDocument::asString(name);
+    if (const JsonNode* seed = document.find(root, "seed")) spec.seed = (Uint64)parseIntView(seed->text, 1);
+    if (const JsonNode* cards = document.find(root, "cards")) spec.cardCount = (Uint32)parseIntView(cards->text, 0);
+
+    const JsonNode* area = document.find(root, "area");
+    spec.areaWidth = std::max(1.0f, JsonDocument::asFloat(document.find(area, "width"), spec.areaWidth));
+    spec.areaHeight = std::max(1.0f, JsonDocument::asFloat(document.find(area, "height"), spec.areaHeight));
+
+    if (const JsonNode* types = document.find(root, "types")) {
+        for (int i = 0; i < CARD_TYPE_COUNT; i++) spec.typeWeights[i] = 0.0f;
+        for (const JsonNode* node = document.firstChild(types); node; node = document.nextSibling(node)) {
+            CardType type;
+            if (!Card::typeFromName(node->key, type)) {
+                printf("[SCENARIO] Unknown card type '%.*s' in %s\n", (int)node->key.size(), node->key.data(), path.c_str());
+                continue;
+            }
+            spec.typeWeights[(int)type] = std::max(0.0f, JsonDocument::asFloat(node));
+        }
+    }
+
+    if (const JsonNode* depths = document.find(root, "stackDepths")) {
+        spec.stackDepthWeights.clear();
+        for (const JsonNode* node = document.firstChild(depths); node; node = document.nextSibling(node)) {
+            spec.stackDepthWeights.push_back(std::max(0.0f, JsonDocument::asFloat(node)));
+        }
+        if (spec.stackDepthWeights.empty()) spec.stackDepthWeights.push_back(1.0f);
+    }
+
+    if (const JsonNode* clusters = document.find(root, "clusters")) {
+        spec.clusterCount = (Uint32)std::max(0.0f, JsonDocument::asFloat(document.find(clusters, "count")));
+        spec.clusterRadius = JsonDocument::asFloat(document.find(clusters, "radius"), spec.clusterRadius);
+        spec.clusteredFraction = JsonDocument::asFloat(document.find(clusters, "fraction"), 1.0f);
+    }
+    spec.craftFraction = JsonDocument::asFloat(document.find(root, "crafts"), 0.0f);
+    if (const JsonNode* piles = document.find(root, "piles")) {
+        spec.pileFraction = JsonDocument::asFloat(document.find(piles, "fraction"), 1.0f);
+        spec.pileMaxCount = (Uint32)std::max(2.0f, JsonDocument::asFloat(document.find(piles, "maxCount"), (float)spec.pileMaxCount));
+    }
+    return true;
+}
+
+// Index drawn with probability proportional to its weight (the last index if all are 0)
+static size_t pickWeighted(SimRandom& random, const float* weights, size_t count, float total) {
+    float roll = random.nextFloat() * total;
+    for (size_t i = 0; i < count; i++) {
+        if (roll < weights[i]) return i;
+        roll -= weights[i];
+    }
+    return count - 1;
+}
+
+void generateScenario(const ScenarioSpec& spec, const std::vector<Recipe>& recipes,
+                      const ScenarioLayout& layout, SaveData& data) {
+    SimRandom random(spec.seed);
+
+    float typeTotal = 0.0f;
+    for (int i = 0; i < CARD_TYPE_COUNT; i++) typeTotal += spec.typeWeights[i];
+    float depthTotal = 0.0f;
+    for (float weight : spec.stackDepthWeights) depthTotal += weight;
+
+    // Recipes short enough to be built as one stack
+    std::vector<int> craftable;
+    for (int i = 0; i < (int)recipes.size(); i++) {
+        if (!recipes[i].ingredients.empty() && (int)recipes[i].ingredients.size() <= layout.maxStackSize) {
+            craftable.push_back(i);
+        }
+    }
+
+    std::vector<Vector2> clusters(spec.clusterCount);
+    for (Vector2& center : clusters) {
+        center = Vector2(random.nextFloat() * spec.areaWidth, random.nextFloat() * spec.areaHeight);
+    }
+
+    data.cards.clear();
+    data.stacks.clear();
+    data.cards.reserve(spec.cardCount);
+    Uint32 nextId = 1;
+    std::vector<CardType> stackTypes;
+
+    while (data.cards.size() < spec.cardCount) {
+        Uint32 remaining = spec.cardCount - (Uint32)data.cards.size();
+        SaveStackRecord stack = {};
+        stack.recipeIndex = -1;
+
+        // Either a recipe's ingredients, mid-craft, a pile, or a random mix of the requested depth
+        Uint32 depth;
+        Uint32 pileCount = 1;
+        if (!craftable.empty() && random.nextFloat() < spec.craftFraction) {
+            int recipeIndex = craftable[random.nextBelow((Uint32)craftable.size())];
+            if (recipes[recipeIndex].ingredients.size() <= remaining) stack.recipeIndex = recipeIndex;
+        }
+        if (stack.recipeIndex >= 0) {
+            const Recipe& recipe = recipes[stack.recipeIndex];
+            depth = (Uint32)recipe.ingredients.size();
+            stackTypes = recipe.ingredients;
+            for (Uint32 i = depth - 1; i > 0; i--) {
+                std::swap(stackTypes[i], stackTypes[random.nextBelow(i + 1)]);
+            }
+            stack.durationTicks = std::max(1u, (Uint32)(recipe.craftTime * SIM_TICK_RATE));
+            stack.remainingTicks = 1 + random.nextBelow(stack.durationTicks);
+        } else if (spec.pileFraction > 0.0f && random.nextFloat() < spec.pileFraction) {
+            // Only drawn when piles are requested, so older scenario files keep their boards
+            depth = 1;
+            pileCount = 2 + random.nextBelow(spec.pileMaxCount - 1);
+            stackTypes.assign(1, (CardType)pickWeighted(random, spec.typeWeights, CARD_TYPE_COUNT, typeTotal));
+        } else {
+            depth = 1 + (Uint32)pickWeighted(random, spec.stackDepthWeights.data(), spec.stackDepthWeights.size(), depthTotal);
+            depth = std::min({depth, remaining, (Uint32)std::max(layout.maxStackSize, 1)});
+            stackTypes.resize(depth);
+            for (Uint32 i = 0; i < depth; i++) {
+                stackTypes[i] = (CardType)pickWeighted(random, spec.typeWeights, CARD_TYPE_COUNT, typeTotal);
+            }
+        }
+
+        Vector2 base;
+        if (!clusters.empty() && random.nextFloat() < spec.clusteredFraction) {
+            // Uniform over a disc around a random cluster center
+            const Vector2& center = clusters[random.nextBelow((Uint32)clusters.size())];
+            float angle = random.nextFloat() * 6.2831853f;
+            float distance = spec.clusterRadius * std::sqrt(random.nextFloat());
+            base = Vector2(center.x + std::cos(angle) * distance, center.y + std::sin(angle) * distance);
+        } else {
+            base = Vector2(random.nextFloat() * spec.areaWidth, random.nextFloat() * spec.areaHeight);
+        }
+
+        stack.stackId = nextId;
+        stack.cardCount = depth;
+        for (Uint32 i = 0; i < depth; i++) {
+            SaveCardRecord card = {};
+            card.id = nextId++;
+            card.stackId = stack.stackId;
+            card.type = (Uint32)stackTypes[i];
+            card.count = pileCount;
+            card.x = base.x + i * layout.stackOffset.x;
+            card.y = base.y + i * layout.stackOffset.y;
+            card.baseX = base.x;
+            card.baseY = base.y;
+            data.cards.push_back(card);
+        }
+        if (stack.recipeIndex >= 0) {
+            // Same bar placement as Game::processRecipes: above the top card
+            float topX = base.x + (depth - 1) * layout.stackOffset.x;
+            float topY = base.y + (depth - 1) * layout.stackOffset.y;
+            stack.barRect = {topX, topY - 12.0f, layout.cardSize.x, 8.0f};
+        }
+        data.stacks.push_back(stack);
+    }
+    data.nextCardId = nextId;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "common.h"
+#include "save_game.h"
+#include <string>
+#include <vector>
+
+// Parameters for a generated board, read from a scenario file (JSON):
+//
+//   {
+//     "name": "100k", "seed": 100, "cards": 100000,
+//     "area": {"width": 8000, "height": 6000},
+//     "types": {"villager": 2, "berry": 3, ...},      relative weights; missing types get 0
+//     "stackDepths": [60, 20, 10, 5, 5],            weight of stacks with 1, 2, 3, ... cards
+//     "clusters": {"count": 200, "radius": 600, "fraction": 0.8},
+//     "crafts": 0.05,                               share of stacks built from a recipe, mid-craft
+//     "piles": {"fraction": 0.5, "maxCount": 1000}  share of other stacks that are one pile of 2..maxCount
+//   }
+//
+// "cards" counts board entities, so a pile adds one however many cards it holds.
+// Every field is optional. The same file and seed always produce the same board.
+struct ScenarioSpec {
+    std::string name;
+    Uint64 seed;
+    Uint32 cardCount;
+    float areaWidth, areaHeight;         // Stacks are placed in [0, width) x [0, height)
+    float typeWeights[CARD_TYPE_COUNT];
+    std::vector<float> stackDepthWeights;
+    Uint32 clusterCount;
+    float clusterRadius;
+    float clusteredFraction;             // Share of stacks placed in a cluster; the rest are uniform
+    float craftFraction;
+    float pileFraction;
+    Uint32 pileMaxCount;
+
+    ScenarioSpec();
+};
+
+bool loadScenario(const std::string& path, ScenarioSpec& spec);
+
+// Card geometry the generated stacks follow, matching Game's stacking layout
+struct ScenarioLayout {
+    Vector2 cardSize;
+    Vector2 stackOffset;   // Offset of each card from the one below it
+    int maxStackSize;
+};
+
+// Fills data.cards, data.stacks and data.nextCardId; hand cards are left alone
+void generateScenario(const ScenarioSpec& spec, const std::vector<Recipe>& recipes,
+                      const ScenarioLayout& layout, SaveData& data);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common.h"
+
+// Small fast PRNG (xoshiro256**) owned by the simulation. Gameplay randomness must
+// come from here, drawn on the simulation thread during a tick, so that a seed and
+// the input events reproduce a session exactly. The state is part of the per-tick
+// state hash.
+class SimRandom {
+private:
+    Uint64 state[4];
+
+    static Uint64 rotl(Uint64 x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    explicit SimRandom(Uint64 seedValue = 1) { seed(seedValue); }
+
+    void seed(Uint64 seedValue) {
+        // Expand the seed with splitmix64, which never yields an all-zero state
+        for (int i = 0; i < 4; i++) {
+            seedValue += 0x9E3779B97F4A7C15ull;
+            Uint64 z = seedValue;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            state[i] = z ^ (z >> 31);
+        }
+    }
+
+    Uint64 next() {
+        Uint64 result = rotl(state[1] * 5, 7) * 9;
+        Uint64 t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound); bound must be non-zero
+    Uint32 nextBelow(Uint32 bound) { return (Uint32)(((next() >> 32) * bound) >> 32); }
+    // Uniform in [0, 1), built from the top 24 bits so every value is exact in a float
+    float nextFloat() { return (float)(next() >> 40) * (1.0f / 16777216.0f); }
+
+    const Uint64* getState() const { return state; }
+};
@@ -0,0 +1,78 @@
+#include "spatial_grid.h"
+#include <algorithm>
+
+// At most this many cells per card; sparser boards get larger cells
+static const size_t CELLS_PER_CARD = 4;
+
+SpatialGrid::SpatialGrid(float minCellSize)
+    : minCellSize(minCellSize), cellSize(minCellSize), originX(0), originY(0), columns(0), rows(0), maxWidth(0), maxHeight(0) {}
+
+void SpatialGrid::rebuild(const std::vector<Card>& cards) {
+    columns = rows = 0;
+    maxWidth = maxHeight = 0;
+    if (cards.empty()) return;
+
+    float minX = cards[0].getPosition().x, minY = cards[0].getPosition().y - cards[0].getAnimationOffset();
+    float maxX = minX, maxY = minY;
+    for (const auto& card : cards) {
+        float x = card.getPosition().x;
+        float y = card.getPosition().y - card.getAnimationOffset();
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+        maxWidth = std::max(maxWidth, card.getSize().x);
+        maxHeight = std::max(maxHeight, card.getSize().y);
+    }
+
+    originX = minX;
+    originY = minY;
+    cellSize = minCellSize;
+    size_t cellLimit = cards.size() * CELLS_PER_CARD;
+    while (true) {
+        columns = (int)((maxX - minX) / cellSize) + 1;
+        rows = (int)((maxY - minY) / cellSize) + 1;
+        if ((size_t)columns * rows <= cellLimit) break;
+        cellSize *= 2.0f;
+    }
+
+    // Pass 1: count cards per cell; pass 2: place them, which keeps indices ascending within a cell
+    size_t cellCount = (size_t)columns * rows;
+    cellStart.assign(cellCount + 1, 0);
+    cardCell.resize(cards.size());
+    entries.resize(cards.size());
+    for (size_t i = 0; i < cards.size(); i++) {
+        int column = (int)((cards[i].getPosition().x - originX) / cellSize);
+        int row = (int)((cards[i].getPosition().y - cards[i].getAnimationOffset() - originY) / cellSize);
+        cardCell[i] = (Uint32)(row * columns + column);
+        cellStart[cardCell[i] + 1]++;
+    }
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+    for (size_t i = 0; i < cards.size(); i++) {
+        entries[cellStart[cardCell[i]]++] = (Uint32)i;
+    }
+    // Placing advanced each start to the next cell's; shift back
+    for (size_t cell = cellCount; cell > 0; cell--) {
+        cellStart[cell] = cellStart[cell - 1];
+    }
+    cellStart[0] = 0;
+}
+
+void SpatialGrid::query(SDL_FRect area, std::vector<Uint32>& out) const {
+    if (columns == 0) return;
+
+    // A card filed in a cell left of / above the area can still reach into it
+    int firstColumn = std::max((int)std::floor((area.x - maxWidth - originX) / cellSize), 0);
+    int firstRow = std::max((int)std::floor((area.y - maxHeight - originY) / cellSize), 0);
+    int lastColumn = std::min((int)std::floor((area.x + area.w - originX) / cellSize), columns - 1);
+    int lastRow = std::min((int)std::floor((area.y + area.h - originY) / cellSize), rows - 1);
+    // An area wholly beside the grid leaves the range empty, and its first column or row off the table
+    if (firstColumn > lastColumn || firstRow > lastRow) return;
+    for (int row = firstRow; row <= lastRow; row++) {
+        Uint32 begin = cellStart[row * columns + firstColumn];
+        Uint32 end = cellStart[row * columns + lastColumn + 1];
+        out.insert(out.end(), entries.begin() + begin, entries.begin() + end); // A row's cells are contiguous
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "card.h"
+#include <vector>
+
+// Uniform grid over the playmat cards for area queries (viewport culling). Each card
+// is filed under the cell holding the top-left corner of its drawn rect, and queries
+// widen their area by the largest card seen so cards reaching in from a neighbouring
+// cell are found. rebuild() is a two-pass counting sort into flat arrays, so once
+// they have grown to the board's size neither rebuilding nor querying allocates.
+// The grid covers the cards' bounding box and coarsens its cells on sparse boards
+// so the cell table stays proportional to the card count.
+class SpatialGrid {
+private:
+    float minCellSize;
+    float cellSize;                // This build's cells: minCellSize, doubled until the table is small enough
+    float originX, originY;
+    int columns, rows;
+    float maxWidth, maxHeight;     // Largest card filed, for widening queries
+    std::vector<Uint32> cellStart; // Cell -> first entry; cellStart[cell + 1] ends it
+    std::vector<Uint32> entries;   // Card indices grouped by cell, ascending within a cell
+    std::vector<Uint32> cardCell;  // Scratch: card index -> cell, between the two passes
+
+public:
+    explicit SpatialGrid(float minCellSize = 256.0f);
+
+    void rebuild(const std::vector<Card>& cards);
+    // Appends the index of every card that may overlap `area`; the caller does the exact
+    // test. Indices come out grouped by cell, not in z-order.
+    void query(SDL_FRect area, std::vector<Uint32>& out) const;
+};
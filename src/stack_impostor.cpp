@@ -0,0 +1,98 @@
+#include "stack_impostor.h"
+#include <cstdio>
+
+// Stack versions start at 1, so no live stack ever matches a stale entry
+static const Uint32 STALE_VERSION = 0;
+
+StackImpostorCache::StackImpostorCache(size_t maxTextures, size_t buildsPerFrame)
+    : capacity(maxTextures), buildBudget(buildsPerFrame), frame(0), frameBuilds(0), building(nullptr) {
+    entries.reserve(capacity + 1); // Buckets up front; entry nodes come from the pool
+}
+
+StackImpostorCache::~StackImpostorCache() {
+    clear();
+}
+
+SDL_Texture* StackImpostorCache::find(Uint32 stackId, const ImpostorKey& key) {
+    auto it = entries.find(stackId);
+    if (it == entries.end() || !(it->second.key == key) || key.version == STALE_VERSION) return nullptr;
+    it->second.lastUsedFrame = frame;
+    return it->second.texture;
+}
+
+SDL_Texture* StackImpostorCache::beginBuild(SDL_Renderer* renderer, Uint32 stackId, const ImpostorKey& key, int width, int height) {
+    if (frameBuilds >= buildBudget || width <= 0 || height <= 0) return nullptr;
+
+    auto it = entries.find(stackId);
+    if (it == entries.end()) {
+        if (entries.size() >= capacity && !evictLeastRecent()) return nullptr;
+        it = entries.emplace(stackId, Entry{nullptr, 0, 0, {STALE_VERSION, 0, 0}, frame}).first;
+    }
+    Entry& entry = it->second;
+
+    // A redraw of the same size (the usual case: same depth) reuses the texture
+    if (entry.texture && (entry.width != width || entry.height != height)) {
+        SDL_DestroyTexture(entry.texture);
+        entry.texture = nullptr;
+    }
+    if (!entry.texture) {
+        entry.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (!entry.texture) {
+            printf("[IMPOSTOR] Could not create a %dx%d texture: %s\n", width, height, SDL_GetError());
+            entries.erase(it);
+            return nullptr;
+        }
+        SDL_SetTextureBlendMode(entry.texture, SDL_BLENDMODE_BLEND); // Rounded corners stay transparent
+        entry.width = width;
+        entry.height = height;
+    }
+    if (!SDL_SetRenderTarget(renderer, entry.texture)) {
+        entry.key.version = STALE_VERSION;
+        return nullptr;
+    }
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    entry.key = key;
+    entry.lastUsedFrame = frame;
+    frameBuilds++;
+    building = renderer;
+    return entry.texture;
+}
+
+void StackImpostorCache::endBuild() {
+    if (!building) return;
+    SDL_SetRenderTarget(building, nullptr);
+    building = nullptr;
+}
+
+bool StackImpostorCache::evictLeastRecent() {
+    // Only runs when a new stack needs a texture while the cache is full, at most buildBudget times a frame
+    auto oldest = entries.begin();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->second.lastUsedFrame < oldest->second.lastUsedFrame) oldest = it;
+    }
+    // Textures drawn this frame stay; evicting them would rebuild the same stacks every frame
+    if (oldest == entries.end() || oldest->second.lastUsedFrame == frame) return false;
+    if (oldest->second.texture) SDL_DestroyTexture(oldest->second.texture);
+    entries.erase(oldest);
+    return true;
+}
+
+void StackImpostorCache::endFrame() {
+    frameBuilds = 0;
+    frame++;
+}
+
+void StackImpostorCache::invalidate() {
+    for (auto& entry : entries) {
+        entry.second.key.version = STALE_VERSION;
+    }
+}
+
+void StackImpostorCache::clear() {
+    for (auto& entry : entries) {
+        if (entry.second.texture) SDL_DestroyTexture(entry.second.texture);
+    }
+    entries.clear();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "pool_allocator.h"
+#include <SDL3/SDL.h>
+#include <unordered_map>
+
+// Pool for the per-stack entries in StackImpostorCache
+struct ImpostorPool {
+    static constexpr const char* name = "stack impostors";
+};
+
+// What an impostor texture shows: the stack at one membership version, and which of
+// its members were drawn (viewport culling leaves out members beyond the screen edge)
+struct ImpostorKey {
+    Uint32 version;
+    Uint32 firstCard;      // Id of the bottom member drawn
+    Uint32 count;          // Members drawn
+    
+    bool operator==(const ImpostorKey& other) const {
+        return version == other.version && firstCard == other.firstCard && count == other.count;
+    }
+};
+
+// Render-thread cache of settled stacks drawn once into offscreen textures
+// ("impostors"), so an unchanged stack costs one textured quad per frame
+// instead of one draw per member card. Entries are keyed by stack id and
+// carry an ImpostorKey holding the stack version the simulation bumps on every
+// membership change; a key mismatch means the texture is stale and is redrawn
+// in place.
+// The cache holds at most `capacity` textures and evicts the least recently
+// drawn stack, and it redraws at most `buildBudget` stacks per frame so a
+// board-wide invalidation is spread over several frames.
+class StackImpostorCache {
+private:
+    struct Entry {
+        SDL_Texture* texture;
+        int width, height;
+        ImpostorKey key;
+        Uint64 lastUsedFrame;
+    };
+    using EntryMap = std::unordered_map<Uint32, Entry, std::hash<Uint32>, std::equal_to<Uint32>,
+                                        PoolAllocator<std::pair<const Uint32, Entry>, ImpostorPool>>;
+
+    EntryMap entries;
+    size_t capacity;
+    size_t buildBudget;
+    Uint64 frame;
+    size_t frameBuilds;
+    SDL_Renderer* building;        // Renderer whose target is bound between beginBuild and endBuild
+
+    bool evictLeastRecent();
+
+public:
+    explicit StackImpostorCache(size_t maxTextures = 512, size_t buildsPerFrame = 16);
+    ~StackImpostorCache();
+    StackImpostorCache(const StackImpostorCache&) = delete;
+    StackImpostorCache& operator=(const StackImpostorCache&) = delete;
+
+    // Current texture for the stack, or nullptr when it has none for this key
+    SDL_Texture* find(Uint32 stackId, const ImpostorKey& key);
+    // Binds a cleared width x height render target for drawing the stack for this key;
+    // returns nullptr when this frame's budget is spent, every cached texture was drawn this
+    // frame, or no texture can be created.
+    // Draw the members with top-left (0, 0) at the stack's bounds, then call endBuild.
+    SDL_Texture* beginBuild(SDL_Renderer* renderer, Uint32 stackId, const ImpostorKey& key, int width, int height);
+    void endBuild();
+
+    // Called once per rendered frame; restores the build budget
+    void endFrame();
+    // Marks every texture stale (render targets were reset or the colors changed)
+    void invalidate();
+    // Destroys every texture; required before the renderer is destroyed or after a device reset
+    void clear();
+
+    size_t getTextureCount() const { return entries.size(); }
+};
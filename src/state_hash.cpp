@@ -0,0 +1,74 @@
+#include "state_hash.h"
+#include "config_parser.h"
+#include <cinttypes>
+#include <cstdlib>
+
+TickHashLog::TickHashLog() : file(nullptr), comparing(false), diverged(false), ticksCompared(0) {}
+
+TickHashLog::~TickHashLog() {
+    stop();
+}
+
+bool TickHashLog::start(const std::string& logPath, const std::string& referencePath) {
+    if (!referencePath.empty()) {
+        std::string text;
+        if (!readConfigFile(referencePath, text)) {
+            printf("[HASH] Could not open reference log %s\n", referencePath.c_str());
+            return false;
+        }
+        reference.clear();
+        const char* cursor = text.c_str();
+        char* lineEnd = nullptr;
+        while (*cursor) {
+            Uint64 tick = strtoull(cursor, &lineEnd, 10);
+            if (lineEnd == cursor) break;
+            Uint64 hash = strtoull(lineEnd, &lineEnd, 16);
+            if (tick >= reference.size()) reference.resize(tick + 1, 0);
+            reference[tick] = hash;
+            cursor = lineEnd;
+            while (*cursor == '\n' || *cursor == '\r') cursor++;
+        }
+        comparing = true;
+        diverged = false;
+        ticksCompared = 0;
+        printf("[HASH] Comparing against %zu ticks from %s\n", reference.size(), referencePath.c_str());
+    }
+
+    if (!logPath.empty()) {
+        file = fopen(logPath.c_str(), "w");
+        if (!file) {
+            printf("[HASH] Could not open %s for writing\n", logPath.c_str());
+            return false;
+        }
+        path = logPath;
+    }
+    return true;
+}
+
+void TickHashLog::record(Uint64 tick, Uint64 hash) {
+    if (file) {
+        fprintf(file, "%" PRIu64 " %016" PRIx64 "\n", (uint64_t)tick, (uint64_t)hash);
+    }
+    if (comparing && !diverged && tick < reference.size()) {
+        ticksCompared++;
+        if (reference[tick] != hash) {
+            diverged = true;
+            printf("[HASH] First divergence at tick %" PRIu64 ": expected %016" PRIx64 ", got %016" PRIx64 "\n",
+                   (uint64_t)tick, (uint64_t)reference[tick], (uint64_t)hash);
+        }
+    }
+}
+
+void TickHashLog::stop() {
+    if (file) {
+        fclose(file);
+        file = nullptr;
+        printf("[HASH] Wrote per-tick hashes to %s\n", path.c_str());
+    }
+    if (comparing) {
+        if (!diverged) {
+            printf("[HASH] %" PRIu64 " ticks matched the reference log\n", (uint64_t)ticksCompared);
+        }
+        comparing = false;
+    }
+}
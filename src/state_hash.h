@@ -0,0 +1,51 @@
+#pragma once
+
+#include "common.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// FNV-1a 64 over raw bytes. Floats are hashed by their bit patterns, so the hash
+// only matches when the simulation is bit-exact.
+class StateHasher {
+private:
+    Uint64 hash;
+
+public:
+    explicit StateHasher(Uint64 seed = 14695981039346656037ull) : hash(seed) {}
+
+    void addBytes(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+
+    template <typename T>
+    void add(const T& value) { addBytes(&value, sizeof(T)); }
+
+    Uint64 get() const { return hash; }
+};
+
+// Per-tick state hashes as text lines "<tick> <hash>", so two logs can be diffed
+// directly. Given a reference log (e.g. from the recording session), reports the
+// first tick whose hash differs.
+class TickHashLog {
+private:
+    FILE* file;
+    std::string path;
+    std::vector<Uint64> reference;   // Hash per tick, indexed by tick
+    bool comparing;
+    bool diverged;
+    Uint64 ticksCompared;
+
+public:
+    TickHashLog();
+    ~TickHashLog();
+
+    // Either path may be empty
+    bool start(const std::string& logPath, const std::string& referencePath);
+    void record(Uint64 tick, Uint64 hash);
+    void stop();
+    bool isActive() const { return file != nullptr || comparing; }
+};
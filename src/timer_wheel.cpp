@@ -0,0 +1,138 @@
+#include "timer_wheel.h"
+
+TimerWheel::TimerWheel() : freeList(NIL), currentTick(0), pendingCount(0), peakCount(0), scheduledCount(0) {
+    for (int i = 0; i < LEVELS * SLOTS; i++) {
+        slots[i] = NIL;
+    }
+}
+
+TimerHandle TimerWheel::schedule(Uint64 delayTicks, Uint32 userData) {
+    // The wheel spans 2^32 ticks; anything further out is clamped to the horizon
+    const Uint64 maxDelay = (1ull << (LEVELS * SLOT_BITS)) - 1;
+    if (delayTicks < 1) delayTicks = 1;
+    if (delayTicks > maxDelay) delayTicks = maxDelay;
+
+    Uint32 index;
+    if (freeList != NIL) {
+        index = freeList;
+        freeList = nodes[index].next;
+    } else {
+        index = (Uint32)nodes.size();
+        Node node;
+        node.generation = 0;
+        nodes.push_back(node);
+    }
+
+    Node& node = nodes[index];
+    node.expires = currentTick + delayTicks;
+    node.userData = userData;
+    insert(index);
+    pendingCount++;
+    if (pendingCount > peakCount) peakCount = pendingCount;
+    scheduledCount++;
+
+    TimerHandle handle;
+    handle.index = index;
+    handle.generation = node.generation;
+    return handle;
+}
+
+bool TimerWheel::cancel(TimerHandle handle) {
+    if (!isPending(handle)) return false;
+    unlink(handle.index);
+    release(handle.index);
+    return true;
+}
+
+bool TimerWheel::isPending(TimerHandle handle) const {
+    if (!handle.isValid() || handle.index >= nodes.size()) return false;
+    const Node& node = nodes[handle.index];
+    return node.generation == handle.generation && node.slot != NIL;
+}
+
+void TimerWheel::advance(std::vector<Uint32>& expired) {
+    currentTick++;
+
+    // Cascade higher levels whose slot boundary we just crossed (top-down)
+    for (int level = LEVELS - 1; level >= 1; level--) {
+        Uint64 mask = (1ull << (level * SLOT_BITS)) - 1;
+        if ((currentTick & mask) == 0) {
+            cascade(level);
+        }
+    }
+
+    // Every timer in the current level-0 slot expires on exactly this tick
+    Uint32 slotIndex = (Uint32)(currentTick & (SLOTS - 1));
+    Uint32 index = slots[slotIndex];
+    slots[slotIndex] = NIL;
+    while (index != NIL) {
+        Uint32 next = nodes[index].next;
+        expired.push_back(nodes[index].userData);
+        release(index);
+        index = next;
+    }
+}
+
+void TimerWheel::clear() {
+    for (Uint32 i = 0; i < (Uint32)nodes.size(); i++) {
+        if (nodes[i].slot != NIL) {
+            release(i);
+        }
+    }
+    for (int i = 0; i < LEVELS * SLOTS; i++) {
+        slots[i] = NIL;
+    }
+}
+
+void TimerWheel::insert(Uint32 nodeIndex) {
+    Node& node = nodes[nodeIndex];
+    Uint64 delta = node.expires - currentTick;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ull << ((level + 1) * SLOT_BITS))) {
+        level++;
+    }
+
+    Uint32 slot = (Uint32)level * SLOTS + (Uint32)((node.expires >> (level * SLOT_BITS)) & (SLOTS - 1));
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = slots[slot];
+    if (node.next != NIL) {
+        nodes[node.next].prev = nodeIndex;
+    }
+    slots[slot] = nodeIndex;
+}
+
+void TimerWheel::unlink(Uint32 nodeIndex) {
+    Node& node = nodes[nodeIndex];
+    if (node.prev != NIL) {
+        nodes[node.prev].next = node.next;
+    } else {
+        slots[node.slot] = node.next;
+    }
+    if (node.next != NIL) {
+        nodes[node.next].prev = node.prev;
+    }
+}
+
+void TimerWheel::release(Uint32 nodeIndex) {
+    Node& node = nodes[nodeIndex];
+    node.slot = NIL;
+    node.generation++;
+    node.next = freeList;
+    freeList = nodeIndex;
+    pendingCount--;
+}
+
+void TimerWheel::cascade(int level) {
+    Uint32 slot = (Uint32)level * SLOTS + (Uint32)((currentTick >> (level * SLOT_BITS)) & (SLOTS - 1));
+    Uint32 index = slots[slot];
+    slots[slot] = NIL;
+
+    // Re-insert relative to the current tick; every timer lands on a lower level
+    while (index != NIL) {
+        Uint32 next = nodes[index].next;
+        insert(index);
+        index = next;
+    }
+}
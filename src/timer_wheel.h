@@ -0,0 +1,69 @@
+#pragma once
+
+#include "pool_allocator.h"
+#include <SDL3/SDL_stdinc.h>
+#include <vector>
+
+// Handle to a scheduled timer. The generation counter makes stale handles
+// (already fired or cancelled) harmless to cancel.
+struct TimerHandle {
+    Uint32 index;
+    Uint32 generation;
+
+    TimerHandle() : index(0xFFFFFFFFu), generation(0) {}
+    bool isValid() const { return index != 0xFFFFFFFFu; }
+};
+
+// Hierarchical timer wheel with 4 levels of 256 slots, counted in simulation ticks.
+// Timers live in intrusive doubly-linked slot lists inside a node pool, so
+// schedule/cancel are O(1) and advance() only touches timers that expire
+// (plus an amortized cascade every 256 ticks), independent of how many are pending.
+class TimerWheel {
+public:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+private:
+    static const Uint32 NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        Uint64 expires;
+        Uint32 userData;
+        Uint32 generation;
+        Uint32 prev;
+        Uint32 next;
+        Uint32 slot;   // Flat slot index (level * SLOTS + slot), NIL when free
+    };
+
+    std::vector<Node> nodes;
+    Uint32 freeList;
+    Uint32 slots[LEVELS * SLOTS];
+    Uint64 currentTick;
+    size_t pendingCount;
+    size_t peakCount;
+    Uint64 scheduledCount;
+
+    void insert(Uint32 nodeIndex);
+    void unlink(Uint32 nodeIndex);
+    void release(Uint32 nodeIndex);
+    void cascade(int level);
+
+public:
+    TimerWheel();
+
+    // Schedules a timer that fires after delayTicks (minimum 1) calls to advance()
+    TimerHandle schedule(Uint64 delayTicks, Uint32 userData);
+    // Returns false if the timer already fired or was cancelled
+    bool cancel(TimerHandle handle);
+    bool isPending(TimerHandle handle) const;
+
+    // Advances the wheel by one tick and appends the userData of every expired timer
+    void advance(std::vector<Uint32>& expired);
+
+    Uint64 getCurrentTick() const { return currentTick; }
+    size_t getPendingCount() const { return pendingCount; }
+    // Occupancy of the node pool, in the same form as FixedBlockPool reports it
+    PoolStats getPoolStats() const { return {"timers", sizeof(Node), nodes.size(), pendingCount, peakCount, scheduledCount}; }
+    void clear();
+};
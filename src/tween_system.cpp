@@ -0,0 +1,133 @@
+#include "tween_system.h"
+#include <cmath>
+
+void TweenSystem::start(Uint32 target, TweenProperty property, float from, float to, float duration, Easing easing) {
+    Uint64 key = makeKey(target, property);
+    auto it = lookup.find(key);
+
+    Uint32 index;
+    if (it != lookup.end()) {
+        index = it->second;
+    } else {
+        index = (Uint32)targets.size();
+        targets.push_back(target);
+        properties.push_back(property);
+        easings.push_back(easing);
+        starts.push_back(from);
+        ends.push_back(to);
+        elapsed.push_back(0.0f);
+        durations.push_back(duration);
+        values.push_back(from);
+        finished.push_back(0);
+        lookup[key] = index;
+    }
+
+    easings[index] = easing;
+    starts[index] = from;
+    ends[index] = to;
+    elapsed[index] = 0.0f;
+    durations[index] = duration > 0.0f ? duration : 0.0001f;
+    values[index] = from;
+    finished[index] = 0;
+}
+
+void TweenSystem::cancel(Uint32 target, TweenProperty property) {
+    auto it = lookup.find(makeKey(target, property));
+    if (it != lookup.end()) {
+        removeAt(it->second);
+    }
+}
+
+void TweenSystem::cancelAll(Uint32 target) {
+    cancel(target, TweenProperty::LIFT);
+    cancel(target, TweenProperty::POSITION_X);
+    cancel(target, TweenProperty::POSITION_Y);
+}
+
+bool TweenSystem::isActive(Uint32 target, TweenProperty property) const {
+    return lookup.find(makeKey(target, property)) != lookup.end();
+}
+
+float TweenSystem::getEndValue(Uint32 target, TweenProperty property, float fallback) const {
+    auto it = lookup.find(makeKey(target, property));
+    return (it != lookup.end()) ? ends[it->second] : fallback;
+}
+
+void TweenSystem::clear() {
+    targets.clear();
+    properties.clear();
+    easings.clear();
+    starts.clear();
+    ends.clear();
+    elapsed.clear();
+    durations.clear();
+    values.clear();
+    finished.clear();
+    lookup.clear();
+}
+
+void TweenSystem::updateRange(size_t begin, size_t end, float dt) {
+    for (size_t i = begin; i < end; i++) {
+        float t = (elapsed[i] + dt) / durations[i];
+        if (t >= 1.0f) {
+            t = 1.0f;
+            finished[i] = 1;
+        }
+        elapsed[i] += dt;
+
+        float eased;
+        switch (easings[i]) {
+            case Easing::EASE_OUT_QUAD:
+                eased = 1.0f - (1.0f - t) * (1.0f - t);
+                break;
+            case Easing::EASE_IN_OUT_CUBIC:
+                eased = t < 0.5f ? 4.0f * t * t * t : 1.0f - 4.0f * (1.0f - t) * (1.0f - t) * (1.0f - t);
+                break;
+            case Easing::ARC:
+                eased = sinf(t * 3.14159265f);
+                break;
+            default:
+                eased = t;
+                break;
+        }
+        values[i] = starts[i] + (ends[i] - starts[i]) * eased;
+    }
+}
+
+void TweenSystem::removeFinished() {
+    for (size_t i = 0; i < targets.size();) {
+        if (finished[i]) {
+            removeAt((Uint32)i); // Swaps the last tween into i, so re-check the same index
+        } else {
+            i++;
+        }
+    }
+}
+
+void TweenSystem::removeAt(Uint32 index) {
+    lookup.erase(makeKey(targets[index], properties[index]));
+
+    Uint32 last = (Uint32)targets.size() - 1;
+    if (index != last) {
+        targets[index] = targets[last];
+        properties[index] = properties[last];
+        easings[index] = easings[last];
+        starts[index] = starts[last];
+        ends[index] = ends[last];
+        elapsed[index] = elapsed[last];
+        durations[index] = durations[last];
+        values[index] = values[last];
+        finished[index] = finished[last];
+        lookup[makeKey(targets[index], properties[index])] = index;
+    }
+
+    targets.pop_back();
+    properties.pop_back();
+    easings.pop_back();
+    starts.pop_back();
+    ends.pop_back();
+    elapsed.pop_back();
+    durations.pop_back();
+    values.pop_back();
+    finished.pop_back();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "pool_allocator.h"
+#include <SDL3/SDL_stdinc.h>
+#include <vector>
+#include <unordered_map>
+
+// Card property a tween drives
+enum class TweenProperty : Uint8 {
+    LIFT,        // Card::animationOffset
+    POSITION_X,
+    POSITION_Y
+};
+
+enum class Easing : Uint8 {
+    LINEAR,
+    EASE_OUT_QUAD,
+    EASE_IN_OUT_CUBIC,
+    ARC          // start -> end -> start along a half sine (pickup bounce)
+};
+
+struct TweenPool {
+    static constexpr const char* name = "tweens";
+};
+
+// Batched tween storage. Active tweens live in parallel contiguous arrays and are
+// advanced together in one loop per tick; Game applies the resulting values to
+// cards afterwards. A target can have at most one tween per property - starting
+// a new one replaces the old one in place.
+class TweenSystem {
+private:
+    std::vector<Uint32> targets;          // Card id
+    std::vector<TweenProperty> properties;
+    std::vector<Easing> easings;
+    std::vector<float> starts;
+    std::vector<float> ends;
+    std::vector<float> elapsed;
+    std::vector<float> durations;
+    std::vector<float> values;            // Output of the last update()
+    std::vector<Uint8> finished;
+
+    // (target, property) -> index; nodes come from the "tweens" pool
+    std::unordered_map<Uint64, Uint32, std::hash<Uint64>, std::equal_to<Uint64>,
+                       PoolAllocator<std::pair<const Uint64, Uint32>, TweenPool>> lookup;
+
+    static Uint64 makeKey(Uint32 target, TweenProperty property) {
+        return ((Uint64)target << 8) | (Uint64)property;
+    }
+    void removeAt(Uint32 index);
+
+public:
+    void start(Uint32 target, TweenProperty property, float from, float to, float duration, Easing easing);
+    void cancel(Uint32 target, TweenProperty property);
+    void cancelAll(Uint32 target);
+    bool isActive(Uint32 target, TweenProperty property) const;
+    // Value the target's tween will settle at, or fallback if none is running
+    float getEndValue(Uint32 target, TweenProperty property, float fallback) const;
+    void clear();
+
+    // Advances every tween by dt seconds and evaluates its current value
+    void update(float dt) { updateRange(0, targets.size(), dt); }
+    // Same for tweens [begin, end); disjoint ranges may run on different threads
+    void updateRange(size_t begin, size_t end, float dt);
+    // Compacts away tweens that finished (or were killed) during the last update
+    void removeFinished();
+    // Marks a tween finished, e.g. when its target no longer exists
+    void kill(size_t index) { finished[index] = 1; }
+
+    size_t size() const { return targets.size(); }
+    Uint32 getTarget(size_t index) const { return targets[index]; }
+    TweenProperty getProperty(size_t index) const { return properties[index]; }
+    float getValue(size_t index) const { return values[index]; }
+    bool isFinished(size_t index) const { return finished[index] != 0; }
+};
@@ -0,0 +1,140 @@
+#include "undo_history.h"
+#include <algorithm>
+
+static UndoSlot makeEmptySlot() {
+    UndoSlot slot = {};
+    slot.craftRecipe = -1;
+    return slot;
+}
+
+UndoHistory::UndoHistory() : live(makeEmptySlot()), nextOrder(0), changed(false), recording(true), limit(100) {}
+
+void UndoHistory::reset(size_t historyLimit) {
+    live.clear();
+    nextOrder = 0;
+    changed = false;
+    limit = historyLimit;
+    undoStack.clear();
+    redoStack.clear();
+}
+
+void UndoHistory::setCard(Uint32 id, Uint32 stackId, CardType type, Uint32 count, Vector2 position, Vector2 base, bool toFront) {
+    if (!recording) return;
+    UndoSlot slot = live.get(id);
+    if (toFront || !slot.live) slot.order = nextOrder++;
+    slot.live = 1;
+    slot.stackId = stackId;
+    slot.type = (Uint8)type;
+    slot.count = count;
+    slot.x = position.x;
+    slot.y = position.y;
+    slot.baseX = base.x;
+    slot.baseY = base.y;
+    live.set(id, slot);
+    changed = true;
+}
+
+void UndoHistory::setStackId(Uint32 id, Uint32 stackId) {
+    if (!recording) return;
+    UndoSlot slot = live.get(id);
+    slot.stackId = stackId;
+    live.set(id, slot);
+    changed = true;
+}
+
+void UndoHistory::eraseCard(Uint32 id) {
+    if (!recording) return;
+    UndoSlot slot = live.get(id);
+    slot.live = 0;
+    live.set(id, slot);
+    changed = true;
+}
+
+void UndoHistory::setCraft(Uint32 stackId, int recipeIndex, Uint32 durationTicks, Uint64 endTick, SDL_FRect bar) {
+    if (!recording) return;
+    UndoSlot slot = live.get(stackId);
+    slot.craftRecipe = recipeIndex;
+    slot.craftDuration = durationTicks;
+    slot.craftEndTick = endTick;
+    slot.craftBar = bar;
+    live.set(stackId, slot);
+    changed = true;
+}
+
+void UndoHistory::clearCraft(Uint32 stackId) {
+    if (!recording) return;
+    UndoSlot slot = live.get(stackId);
+    if (slot.craftRecipe == -1) return;
+    slot.craftRecipe = -1;
+    live.set(stackId, slot);
+    changed = true;
+}
+
+void UndoHistory::beginAction() {
+    // Nothing changed since the newest entry: it already holds this state
+    if (!changed && !undoStack.empty()) return;
+    undoStack.push_back({live, nextOrder});
+    if (undoStack.size() > limit) {
+        undoStack.pop_front();
+    }
+    redoStack.clear();
+    changed = false;
+}
+
+bool UndoHistory::undo(Uint64 tick, SaveData& data) {
+    // Right after beginAction() with no mutation since, the newest entry is the live state itself
+    if (!changed && !undoStack.empty()) undoStack.pop_back();
+    if (undoStack.empty()) return false;
+
+    redoStack.push_back({live, nextOrder});
+    live = undoStack.back().slots;
+    nextOrder = undoStack.back().nextOrder;
+    undoStack.pop_back();
+    changed = true; // The newest entry (if any) is now older than the live state
+    toSaveData(tick, data);
+    return true;
+}
+
+bool UndoHistory::redo(Uint64 tick, SaveData& data) {
+    if (redoStack.empty()) return false;
+    undoStack.push_back({live, nextOrder});
+    live = redoStack.back().slots;
+    nextOrder = redoStack.back().nextOrder;
+    redoStack.pop_back();
+    changed = true;
+    toSaveData(tick, data);
+    return true;
+}
+
+void UndoHistory::toSaveData(Uint64 tick, SaveData& data) const {
+    // Materializing walks the whole table; that only happens on undo/redo, not per action
+    std::vector<Uint32> ids;
+    for (Uint32 id = 0; id < (Uint32)live.size(); id++) {
+        if (live.get(id).live) ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end(), [this](Uint32 a, Uint32 b) { return live.get(a).order < live.get(b).order; });
+
+    data.cards.clear();
+    data.stacks.clear();
+    std::vector<Uint32> stackCounts(live.size(), 0);
+    for (Uint32 id : ids) {
+        const UndoSlot& slot = live.get(id);
+        SaveCardRecord record = {id, slot.stackId, slot.type, slot.count, slot.x, slot.y, slot.baseX, slot.baseY};
+        data.cards.push_back(record);
+        if (slot.stackId < stackCounts.size()) stackCounts[slot.stackId]++;
+    }
+    for (Uint32 id : ids) {
+        const UndoSlot& slot = live.get(id);
+        if (slot.stackId != id) continue; // One record per stack, from its root card
+        SaveStackRecord stack = {};
+        stack.stackId = id;
+        stack.cardCount = stackCounts[id];
+        stack.recipeIndex = slot.craftRecipe;
+        if (slot.craftRecipe >= 0) {
+            stack.durationTicks = slot.craftDuration;
+            stack.remainingTicks = slot.craftEndTick > tick ? (Uint32)(slot.craftEndTick - tick) : 1;
+            stack.barRect = slot.craftBar;
+        }
+        data.stacks.push_back(stack);
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "common.h"
+#include "cow_array.h"
+#include "save_game.h"
+#include <deque>
+
+// Undo state of one card id. Crafts are keyed by stack id, which is the id of
+// the stack's root card, so they share the slot of that card.
+struct UndoSlot {
+    Uint64 order;          // Z-order key; larger is in front
+    Uint32 stackId;
+    Uint8 live;
+    Uint8 type;
+    Uint32 count;          // Pile size
+    float x, y;            // Where the card rests (end of any slide)
+    float baseX, baseY;
+    Sint32 craftRecipe;    // -1 when no craft runs on this stack
+    Uint32 craftDuration;
+    Uint64 craftEndTick;
+    SDL_FRect craftBar;
+};
+
+// Undo/redo history over a card-id-indexed CowArray of UndoSlots. Game reports
+// every board mutation as it happens, so the live table is always current, and
+// each user action snapshots it by copying page pointers: the snapshot shares
+// every chunk with the live table until a later mutation writes to it. A
+// snapshot therefore costs O(chunks changed since the last one), and the
+// history is capped at `limit` entries so memory stays bounded.
+class UndoHistory {
+private:
+    struct Snapshot {
+        CowArray<UndoSlot> slots;
+        Uint64 nextOrder;
+    };
+
+    CowArray<UndoSlot> live;
+    Uint64 nextOrder;
+    bool changed;          // Live table differs from the newest undo entry
+    bool recording;
+    size_t limit;
+    std::deque<Snapshot> undoStack;
+    std::vector<Snapshot> redoStack;
+
+    UndoSlot& writable(Uint32 id, UndoSlot& slot);
+    void toSaveData(Uint64 tick, SaveData& data) const;
+
+public:
+    UndoHistory();
+
+    // Forgets all history; the board is then re-reported through setCard/setCraft
+    void reset(size_t historyLimit);
+    // While off (e.g. during a restore driven by undo()), mutations are ignored
+    void setRecording(bool enabled) { recording = enabled; }
+
+    // Mutation reports
+    void setCard(Uint32 id, Uint32 stackId, CardType type, Uint32 count, Vector2 position, Vector2 base, bool toFront);
+    void setStackId(Uint32 id, Uint32 stackId);
+    void eraseCard(Uint32 id);
+    void setCraft(Uint32 stackId, int recipeIndex, Uint32 durationTicks, Uint64 endTick, SDL_FRect bar);
+    void clearCraft(Uint32 stackId);
+
+    // Records the state before a user action
+    void beginAction();
+    // Step through the history; fill `data` (playmat and crafts) with the state to restore
+    bool undo(Uint64 tick, SaveData& data);
+    bool redo(Uint64 tick, SaveData& data);
+
+    size_t getUndoCount() const { return undoStack.size(); }
+    size_t getRedoCount() const { return redoStack.size(); }
+};